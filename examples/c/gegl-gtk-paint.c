@@ -76,9 +76,12 @@ static gboolean paint_press(GtkWidget      *widget,
                                          "stroke-width", LINEWIDTH,
                                          "stroke-hardness", HARDNESS,
                                          NULL);
+        /* The view processes the graph in a worker thread */
+        gegl_gtk_view_lock_graph(GEGL_GTK_VIEW(view));
         gegl_node_link_many(top, over, out, NULL);
         gegl_node_connect_to(stroke, "output", over, "aux");
         gegl_path_append(vector, 'M', x, y);
+        gegl_gtk_view_unlock_graph(GEGL_GTK_VIEW(view));
 
         pen_down = TRUE;
 
@@ -101,7 +104,9 @@ static gboolean paint_motion(GtkWidget      *widget,
             return TRUE;
         }
 
+        gegl_gtk_view_lock_graph(GEGL_GTK_VIEW(view));
         gegl_path_append(vector, 'L', x, y);
+        gegl_gtk_view_unlock_graph(GEGL_GTK_VIEW(view));
         return TRUE;
     }
     return FALSE;
@@ -117,6 +122,8 @@ static gboolean paint_release(GtkWidget      *widget,
         GeglNode      *writebuf;
         GeglRectangle  roi;
 
+        gegl_gtk_view_lock_graph(GEGL_GTK_VIEW(view));
+
         gegl_path_get_bounds(vector, &x0, &x1, &y0, &y1);
 
         roi.x = x0 - LINEWIDTH;
@@ -144,6 +151,8 @@ static gboolean paint_release(GtkWidget      *widget,
         stroke   = NULL;
         pen_down = FALSE;
 
+        gegl_gtk_view_unlock_graph(GEGL_GTK_VIEW(view));
+
         return TRUE;
     }
     return FALSE;
@@ -208,9 +217,9 @@ main(gint    argc,
         gegl_node_link_many(loadbuf, out, NULL);
 
         view = GTK_WIDGET(gegl_gtk_view_new_for_node(out));
-        gegl_gtk_view_set_x(GEGL_GTK_VIEW(view), -50.0);
-        gegl_gtk_view_set_y(GEGL_GTK_VIEW(view), -50.0);
+        gegl_gtk_view_set_transform(GEGL_GTK_VIEW(view), -50.0, -50.0, 1.0);
         gegl_gtk_view_set_autoscale_policy(GEGL_GTK_VIEW(view), GEGL_GTK_VIEW_AUTOSCALE_DISABLED);
+        g_object_set(G_OBJECT(view), "threaded", TRUE, NULL);
         top  = loadbuf;
     }
 
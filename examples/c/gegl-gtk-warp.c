@@ -67,8 +67,10 @@ static GeglNode         *readbuf; /* node to read this image */
 static gboolean
 add_event_timer (gpointer data)
 {
+  gegl_gtk_view_lock_graph (GEGL_GTK_VIEW (view));
   gegl_path_append (current_stroke,
                     'L', cursor_x, cursor_y);
+  gegl_gtk_view_unlock_graph (GEGL_GTK_VIEW (view));
   return TRUE;
 }
 
@@ -97,6 +99,9 @@ add_op ()
 static gboolean paint_press (GtkWidget      *widget,
                              GdkEventButton *event)
 {
+  /* The view processes the graph in a worker thread */
+  gegl_gtk_view_lock_graph (GEGL_GTK_VIEW (view));
+
   if (current_stroke)
     g_object_unref (current_stroke);
 
@@ -109,6 +114,8 @@ static gboolean paint_press (GtkWidget      *widget,
 
   add_op ();
 
+  gegl_gtk_view_unlock_graph (GEGL_GTK_VIEW (view));
+
   stroke_timer = g_timeout_add (STROKE_PERIOD, add_event_timer, NULL);
   return TRUE;
 }
@@ -184,7 +191,11 @@ main (gint    argc,
 
   create_graph ();
 
-  view = g_object_new (GEGL_GTK_TYPE_VIEW, "node", render_node, NULL);
+  view = g_object_new (GEGL_GTK_TYPE_VIEW,
+                       "node", render_node,
+                       "threaded", TRUE,
+                       "progressive", TRUE,
+                       NULL);
 
   eventbox = gtk_event_box_new ();
 
@@ -38,6 +38,22 @@ typedef enum {
 GType gegl_gtk_view_autoscale_get_type(void) G_GNUC_CONST;
 #define GEGL_GTK_TYPE_VIEW_AUTOSCALE (gegl_gtk_view_autoscale_get_type())
 
+/**
+ * GeglGtkViewFilter:
+ * @GEGL_GTK_VIEW_FILTER_NEAREST: Show model pixels as sharp squares
+ * @GEGL_GTK_VIEW_FILTER_BILINEAR: Interpolate between model pixels
+ *
+ * Specifies how #GeglGtkView magnifies the node when zoomed in
+ * beyond its native resolution.
+ **/
+typedef enum {
+    GEGL_GTK_VIEW_FILTER_NEAREST = 0,
+    GEGL_GTK_VIEW_FILTER_BILINEAR
+} GeglGtkViewFilter;
+
+GType gegl_gtk_view_filter_get_type(void) G_GNUC_CONST;
+#define GEGL_GTK_TYPE_VIEW_FILTER (gegl_gtk_view_filter_get_type())
+
 G_END_DECLS
 
 #endif /* __GEGL_GTK_ENUMS_H__ */
@@ -22,6 +22,7 @@
 #include <glib-object.h>
 #include <gtk/gtk.h>
 #include <gegl.h>
+#include <math.h>
 
 #ifdef HAVE_CAIRO_GOBJECT
 #include <cairo-gobject.h>
@@ -31,6 +32,11 @@
 #include "internal/view-helper.h"
 #include "gegl-gtk-marshal.h"
 
+/* With a frame clock, redraws are collected and queued once per frame */
+#if defined(HAVE_GTK3) && GTK_CHECK_VERSION(3, 8, 0)
+#define USE_FRAME_CLOCK 1
+#endif
+
 /**
  * SECTION:gegl-gtk-view
  * @short_description: Widget for displaying a #GeglNode
@@ -73,12 +79,19 @@
  * a widget and rely on the presence and behaviour of a windowing system.
  */
 
-/*
- * TODO: Emit a transformation-changed signal whenever the tranformation changes
- */
-
 G_DEFINE_TYPE(GeglGtkView, gegl_gtk_view, GTK_TYPE_DRAWING_AREA)
 
+static GeglGtkViewStats *
+stats_copy(const GeglGtkViewStats *stats)
+{
+    GeglGtkViewStats *copy = g_new(GeglGtkViewStats, 1);
+
+    *copy = *stats;
+    return copy;
+}
+
+G_DEFINE_BOXED_TYPE(GeglGtkViewStats, gegl_gtk_view_stats, stats_copy, g_free)
+
 
 enum {
     PROP_0,
@@ -87,18 +100,27 @@ enum {
     PROP_Y,
     PROP_SCALE,
     PROP_BLOCK,
-    PROP_AUTOSCALE_POLICY
+    PROP_AUTOSCALE_POLICY,
+    PROP_PROCESSING_BUDGET,
+    PROP_PROCESSING_PRIORITY,
+    PROP_THREADED,
+    PROP_RENDER_THREADS,
+    PROP_PROGRESSIVE,
+    PROP_FILTER,
+    PROP_INTERACTIVE,
+    PROP_PAUSE_WHEN_HIDDEN
 };
 
-#ifdef HAVE_CAIRO_GOBJECT
 enum {
+#ifdef HAVE_CAIRO_GOBJECT
     SIGNAL_DRAW_BACKGROUND,
     SIGNAL_DRAW_OVERLAY,
+#endif
+    SIGNAL_TRANSFORMATION_CHANGED,
     N_SIGNALS
 };
 
 static guint gegl_view_signals[N_SIGNALS];
-#endif
 
 static ViewHelper *
 get_private(GeglGtkView *self)
@@ -134,10 +156,28 @@ static gboolean  draw(GtkWidget *widget,
 static void
 trigger_redraw(ViewHelper *priv, GeglRectangle *rect, GeglGtkView *view);
 static void
+trigger_scroll(ViewHelper *priv, gint dx, gint dy, GeglGtkView *view);
+static void
 size_allocate(GtkWidget *widget, GdkRectangle *allocation, gpointer user_data);
+static void
+update_suspended(GeglGtkView *self);
+static void
+widget_mapped(GtkWidget *widget, gpointer user_data);
+static gboolean
+visibility_notify(GtkWidget *widget, GdkEventVisibility *event, gpointer user_data);
+static void
+hierarchy_changed(GtkWidget *widget, GtkWidget *previous_toplevel, gpointer user_data);
+static gboolean
+pointer_motion(GtkWidget *widget, GdkEventMotion *event, gpointer user_data);
+static gboolean
+pointer_leave(GtkWidget *widget, GdkEventCrossing *event, gpointer user_data);
 
 static void
 view_size_changed(ViewHelper *priv, GeglRectangle *rect, GeglGtkView *view);
+static void
+interactive_changed(ViewHelper *priv, gboolean interactive, GeglGtkView *view);
+static void
+transformation_changed(ViewHelper *priv, GeglGtkView *view);
 
 static void
 gegl_gtk_view_class_init(GeglGtkViewClass *klass)
@@ -175,7 +215,7 @@ gegl_gtk_view_class_init(GeglGtkViewClass *klass)
                                     g_param_spec_double("scale",
                                             "Scale",
                                             "Zoom factor",
-                                            0.0, 100.0, 1.00,
+                                            VIEW_HELPER_MIN_SCALE, VIEW_HELPER_MAX_SCALE, 1.00,
                                             G_PARAM_CONSTRUCT |
                                             G_PARAM_READWRITE));
     g_object_class_install_property(gobject_class, PROP_NODE,
@@ -198,6 +238,63 @@ gegl_gtk_view_class_init(GeglGtkViewClass *klass)
                                             GEGL_GTK_VIEW_AUTOSCALE_CONTENT,
                                             G_PARAM_READWRITE |
                                             G_PARAM_CONSTRUCT));
+    g_object_class_install_property(gobject_class, PROP_FILTER,
+                                    g_param_spec_enum("filter",
+                                            "Filter", "How the node is magnified when zoomed in beyond its resolution",
+                                            GEGL_GTK_TYPE_VIEW_FILTER,
+                                            GEGL_GTK_VIEW_FILTER_NEAREST,
+                                            G_PARAM_READWRITE));
+    g_object_class_install_property(gobject_class, PROP_INTERACTIVE,
+                                    g_param_spec_boolean("interactive",
+                                            "Interactive",
+                                            "Render at reduced quality, to keep pans and zooms smooth. "
+                                            "Set automatically on rapid transformation changes, "
+                                            "and cleared after a short quiet period. "
+                                            "When set explicitly, lasts until cleared.",
+                                            FALSE,
+                                            G_PARAM_READWRITE));
+    g_object_class_install_property(gobject_class, PROP_PAUSE_WHEN_HIDDEN,
+                                    g_param_spec_boolean("pause-when-hidden",
+                                            "Pause when hidden",
+                                            "Pause processing and redrawing while the view is unmapped, "
+                                            "fully obscured or in a minimized window",
+                                            TRUE,
+                                            G_PARAM_READWRITE));
+    g_object_class_install_property(gobject_class, PROP_PROCESSING_BUDGET,
+                                    g_param_spec_int("processing-budget",
+                                            "Processing budget",
+                                            "Time to spend processing the node per main loop iteration, in microseconds. "
+                                            "0 processes a single chunk per iteration.",
+                                            0, G_MAXINT, 8000,
+                                            G_PARAM_READWRITE));
+    g_object_class_install_property(gobject_class, PROP_PROCESSING_PRIORITY,
+                                    g_param_spec_int("processing-priority",
+                                            "Processing priority",
+                                            "Main loop priority used for processing the node",
+                                            G_PRIORITY_HIGH, G_MAXINT, G_PRIORITY_LOW,
+                                            G_PARAM_READWRITE));
+    g_object_class_install_property(gobject_class, PROP_THREADED,
+                                    g_param_spec_boolean("threaded",
+                                            "Threaded processing",
+                                            "Process the node in a worker thread instead of in the main loop. "
+                                            "The graph must then only be modified from the main thread, "
+                                            "between gegl_gtk_view_lock_graph() and gegl_gtk_view_unlock_graph().",
+                                            FALSE,
+                                            G_PARAM_READWRITE));
+    g_object_class_install_property(gobject_class, PROP_RENDER_THREADS,
+                                    g_param_spec_int("render-threads",
+                                            "Render threads",
+                                            "Number of threads used for rendering tiles while drawing. "
+                                            "0 uses the number of threads GEGL is configured with.",
+                                            0, G_MAXINT, 0,
+                                            G_PARAM_READWRITE));
+    g_object_class_install_property(gobject_class, PROP_PROGRESSIVE,
+                                    g_param_spec_boolean("progressive",
+                                            "Progressive rendering",
+                                            "Show changed areas at a low level of detail first, "
+                                            "and refine them to full resolution afterwards.",
+                                            FALSE,
+                                            G_PARAM_READWRITE));
 
 
 /* XXX: maybe we should just allow a second GeglNode to be specified for background? */
@@ -253,6 +350,23 @@ gegl_gtk_view_class_init(GeglGtkViewClass *klass)
                      G_TYPE_NONE, 2, CAIRO_GOBJECT_TYPE_CONTEXT, GDK_TYPE_RECTANGLE);
 #endif
 
+/**
+* GeglGtkView::transformation-changed:
+* @widget: the #GeglGtkView widget that emitted the signal
+*
+* Emitted after the :x, :y or :scale of the view changed.
+* Emitted once for gegl_gtk_view_set_transform(), even if it changed
+* more than one of them.
+**/
+    gegl_view_signals[SIGNAL_TRANSFORMATION_CHANGED] =
+        g_signal_new("transformation-changed",
+                     G_TYPE_FROM_CLASS(klass),
+                     G_SIGNAL_RUN_LAST,
+                     0,
+                     NULL,
+                     NULL,
+                     g_cclosure_marshal_VOID__VOID,
+                     G_TYPE_NONE, 0);
 }
 
 static void
@@ -260,10 +374,23 @@ gegl_gtk_view_init(GeglGtkView *self)
 {
     self->priv = (GeglGtkViewPrivate *)view_helper_new();
 
+    /* Until mapped and allocated it is not known what will be visible */
+    view_helper_set_suspended(GET_PRIVATE(self), TRUE);
+
     g_signal_connect(self->priv, "redraw-needed", G_CALLBACK(trigger_redraw), (gpointer)self);
+    g_signal_connect(self->priv, "scroll-needed", G_CALLBACK(trigger_scroll), (gpointer)self);
     g_signal_connect(self->priv, "size-changed", G_CALLBACK(view_size_changed), (gpointer)self);
+    g_signal_connect(self->priv, "interactive-changed", G_CALLBACK(interactive_changed), (gpointer)self);
+    g_signal_connect(self->priv, "transformation-changed", G_CALLBACK(transformation_changed), (gpointer)self);
 
     g_signal_connect(self, "size-allocate", G_CALLBACK(size_allocate), NULL);
+    g_signal_connect(self, "map", G_CALLBACK(widget_mapped), NULL);
+    g_signal_connect(self, "unmap", G_CALLBACK(widget_mapped), NULL);
+    g_signal_connect(self, "visibility-notify-event", G_CALLBACK(visibility_notify), NULL);
+    g_signal_connect(self, "hierarchy-changed", G_CALLBACK(hierarchy_changed), NULL);
+    gtk_widget_add_events(GTK_WIDGET(self), GDK_VISIBILITY_NOTIFY_MASK);
+    g_signal_connect(self, "motion-notify-event", G_CALLBACK(pointer_motion), NULL);
+    g_signal_connect(self, "leave-notify-event", G_CALLBACK(pointer_leave), NULL);
 }
 
 static void
@@ -304,6 +431,31 @@ set_property(GObject      *gobject,
     case PROP_AUTOSCALE_POLICY:
         gegl_gtk_view_set_autoscale_policy(self, g_value_get_enum(value));
         break;
+    case PROP_PROCESSING_BUDGET:
+        view_helper_set_processing_budget(priv, g_value_get_int(value));
+        break;
+    case PROP_PROCESSING_PRIORITY:
+        view_helper_set_processing_priority(priv, g_value_get_int(value));
+        break;
+    case PROP_THREADED:
+        view_helper_set_threaded(priv, g_value_get_boolean(value));
+        break;
+    case PROP_RENDER_THREADS:
+        view_helper_set_render_threads(priv, g_value_get_int(value));
+        break;
+    case PROP_PROGRESSIVE:
+        view_helper_set_progressive(priv, g_value_get_boolean(value));
+        break;
+    case PROP_FILTER:
+        view_helper_set_filter(priv, g_value_get_enum(value));
+        break;
+    case PROP_INTERACTIVE:
+        view_helper_set_interactive(priv, g_value_get_boolean(value));
+        break;
+    case PROP_PAUSE_WHEN_HIDDEN:
+        priv->pause_when_hidden = g_value_get_boolean(value);
+        update_suspended(self);
+        break;
     default:
 
         G_OBJECT_WARN_INVALID_PROPERTY_ID(gobject, property_id, pspec);
@@ -339,23 +491,115 @@ get_property(GObject      *gobject,
     case PROP_AUTOSCALE_POLICY:
         g_value_set_enum(value, gegl_gtk_view_get_autoscale_policy(self));
         break;
+    case PROP_PROCESSING_BUDGET:
+        g_value_set_int(value, view_helper_get_processing_budget(priv));
+        break;
+    case PROP_PROCESSING_PRIORITY:
+        g_value_set_int(value, view_helper_get_processing_priority(priv));
+        break;
+    case PROP_THREADED:
+        g_value_set_boolean(value, view_helper_get_threaded(priv));
+        break;
+    case PROP_RENDER_THREADS:
+        g_value_set_int(value, view_helper_get_render_threads(priv));
+        break;
+    case PROP_PROGRESSIVE:
+        g_value_set_boolean(value, view_helper_get_progressive(priv));
+        break;
+    case PROP_FILTER:
+        g_value_set_enum(value, view_helper_get_filter(priv));
+        break;
+    case PROP_INTERACTIVE:
+        g_value_set_boolean(value, view_helper_get_interactive(priv));
+        break;
+    case PROP_PAUSE_WHEN_HIDDEN:
+        g_value_set_boolean(value, priv->pause_when_hidden);
+        break;
     default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID(gobject, property_id, pspec);
         break;
     }
 }
 
-/* Trigger a redraw */
+#ifdef USE_FRAME_CLOCK
+/* Queue the damage collected since the last frame, as a single redraw */
+static gboolean
+flush_damage(GtkWidget *widget, GdkFrameClock *frame_clock, gpointer user_data)
+{
+    GeglGtkView *self = GEGL_GTK_VIEW(widget);
+    ViewHelper *priv = GET_PRIVATE(self);
+
+    if (priv->damage_all)
+        gtk_widget_queue_draw(widget);
+    else if (!cairo_region_is_empty(priv->damage_region))
+        gtk_widget_queue_draw_region(widget, priv->damage_region);
+
+    cairo_region_destroy(priv->damage_region);
+    priv->damage_region = cairo_region_create();
+    priv->damage_all = FALSE;
+    priv->damage_tick_id = 0;
+
+    return G_SOURCE_REMOVE;
+}
+#endif
+
+/* Trigger a redraw
+ * With a frame clock, the area is added to the damage which is
+ * flushed on the next frame, instead of being queued right away */
 static void
 trigger_redraw(ViewHelper *priv,
                GeglRectangle *rect,
                GeglGtkView *view)
 {
+#ifdef USE_FRAME_CLOCK
+    if (rect->width < 0 || rect->height < 0) {
+        priv->damage_all = TRUE;
+    } else {
+        cairo_rectangle_int_t area = { rect->x, rect->y, rect->width, rect->height };
+        cairo_region_union_rectangle(priv->damage_region, &area);
+    }
+
+    if (!priv->damage_tick_id)
+        priv->damage_tick_id = gtk_widget_add_tick_callback(GTK_WIDGET(view),
+                                                            flush_damage, NULL, NULL);
+#else
     if (rect->width < 0 || rect->height < 0)
         gtk_widget_queue_draw(GTK_WIDGET(view));
     else
         gtk_widget_queue_draw_area(GTK_WIDGET(view),
                                    rect->x, rect->y, rect->width, rect->height);
+#endif
+}
+
+/* Scroll the pixels already drawn, so that only the newly exposed areas
+ * need to be redrawn.
+ * Falls back to a full redraw when consumers draw a background or overlay,
+ * as those are not necessarily attached to the content. */
+static void
+trigger_scroll(ViewHelper *priv,
+               gint dx, gint dy,
+               GeglGtkView *view)
+{
+    GtkWidget *widget = GTK_WIDGET(view);
+    GdkWindow *window = gtk_widget_get_window(widget);
+    gboolean can_scroll = window && gtk_widget_is_drawable(widget);
+
+#ifdef USE_FRAME_CLOCK
+    /* Damage not yet flushed moves along with the content */
+    cairo_region_translate(priv->damage_region, -dx, -dy);
+#endif
+
+#ifdef HAVE_CAIRO_GOBJECT
+    if (g_signal_has_handler_pending(view, gegl_view_signals[SIGNAL_DRAW_BACKGROUND], 0, FALSE) ||
+            g_signal_has_handler_pending(view, gegl_view_signals[SIGNAL_DRAW_OVERLAY], 0, FALSE)) {
+        can_scroll = FALSE;
+    }
+#endif
+
+    if (can_scroll)
+        gdk_window_scroll(window, -dx, -dy);
+    else
+        gtk_widget_queue_draw(widget);
 }
 
 /* Bounding box of the node view changed */
@@ -369,54 +613,191 @@ view_size_changed(ViewHelper *priv, GeglRectangle *rect, GeglGtkView *view)
     gtk_widget_set_size_request(GTK_WIDGET(view), rect->width, rect->height);
 }
 
+static void
+interactive_changed(ViewHelper *priv, gboolean interactive, GeglGtkView *view)
+{
+    g_object_notify(G_OBJECT(view), "interactive");
+}
+
+static void
+transformation_changed(ViewHelper *priv, GeglGtkView *view)
+{
+    g_signal_emit(G_OBJECT(view), gegl_view_signals[SIGNAL_TRANSFORMATION_CHANGED], 0, NULL);
+}
+
+/* Processing is suspended until the widget has an allocation, so that only
+ * what will initially be visible gets processed. With :pause-when-hidden
+ * it is also suspended while the widget cannot be seen. */
+static void
+update_suspended(GeglGtkView *self)
+{
+    ViewHelper *priv = GET_PRIVATE(self);
+    gboolean mapped, hidden;
+
+#if GTK_CHECK_VERSION(2, 20, 0)
+    mapped = gtk_widget_get_mapped(GTK_WIDGET(self));
+#else
+    mapped = GTK_WIDGET_MAPPED(GTK_WIDGET(self));
+#endif
+    hidden = !mapped || priv->widget_obscured || priv->widget_iconified;
+
+    view_helper_set_suspended(priv, priv->widget_allocation.width < 0 ||
+                              (hidden && priv->pause_when_hidden));
+}
+
 static void
 size_allocate(GtkWidget *widget, GdkRectangle *allocation, gpointer user_data)
 {
     GeglGtkView *self = GEGL_GTK_VIEW(widget);
     view_helper_set_allocation(GET_PRIVATE(self), allocation);
+    update_suspended(self);
 }
 
+/* Handles both map and unmap */
 static void
-draw_implementation(GeglGtkView *self, cairo_t *cr, GdkRectangle *rect)
+widget_mapped(GtkWidget *widget, gpointer user_data)
+{
+    update_suspended(GEGL_GTK_VIEW(widget));
+}
+
+static gboolean
+visibility_notify(GtkWidget *widget, GdkEventVisibility *event, gpointer user_data)
+{
+    GeglGtkView *self = GEGL_GTK_VIEW(widget);
+
+    GET_PRIVATE(self)->widget_obscured = event->state == GDK_VISIBILITY_FULLY_OBSCURED;
+    update_suspended(self);
+    return FALSE;
+}
+
+static gboolean
+toplevel_window_state(GtkWidget *toplevel, GdkEventWindowState *event, GeglGtkView *self)
+{
+    GET_PRIVATE(self)->widget_iconified = (event->new_window_state & GDK_WINDOW_STATE_ICONIFIED) != 0;
+    update_suspended(self);
+    return FALSE;
+}
+
+/* Follow the window state of the toplevel the view is in,
+ * a minimized window stays mapped */
+static void
+hierarchy_changed(GtkWidget *widget, GtkWidget *previous_toplevel, gpointer user_data)
+{
+    GeglGtkView *self = GEGL_GTK_VIEW(widget);
+    GtkWidget *toplevel = gtk_widget_get_toplevel(widget);
+
+    if (previous_toplevel)
+        g_signal_handlers_disconnect_by_func(previous_toplevel,
+                                             toplevel_window_state, self);
+
+    GET_PRIVATE(self)->widget_iconified = FALSE;
+
+    if (gtk_widget_is_toplevel(toplevel) && GTK_IS_WINDOW(toplevel))
+        g_signal_connect_object(toplevel, "window-state-event",
+                                G_CALLBACK(toplevel_window_state), self, 0);
+
+    update_suspended(self);
+}
+
+/* Processing is prioritized around the pointer, when the consumer
+ * enables pointer motion events on the widget */
+static gboolean
+pointer_motion(GtkWidget *widget, GdkEventMotion *event, gpointer user_data)
+{
+    GeglGtkView *self = GEGL_GTK_VIEW(widget);
+    view_helper_set_pointer(GET_PRIVATE(self), TRUE, event->x, event->y);
+    return FALSE;
+}
+
+static gboolean
+pointer_leave(GtkWidget *widget, GdkEventCrossing *event, gpointer user_data)
+{
+    GeglGtkView *self = GEGL_GTK_VIEW(widget);
+    view_helper_set_pointer(GET_PRIVATE(self), FALSE, 0.0, 0.0);
+    return FALSE;
+}
+
+/* Draw the area covered by @region, in view coordinates.
+ * Only the rectangles of @region are rendered, not its bounding box.
+ * The bounding box is what is passed on to the signal handlers. */
+static void
+draw_implementation(GeglGtkView *self, cairo_t *cr, cairo_region_t *region)
 {
     ViewHelper *priv = GET_PRIVATE(self);
+    GdkRectangle rect;
+
+    cairo_region_get_extents(region, (cairo_rectangle_int_t *)&rect);
 
 #ifdef HAVE_CAIRO_GOBJECT
     /* Draw background */
     cairo_save(cr);
     g_signal_emit(G_OBJECT(self), gegl_view_signals[SIGNAL_DRAW_BACKGROUND],
-                  0, cr, rect, NULL);
+                  0, cr, &rect, NULL);
     cairo_restore(cr);
 #endif
 
     /* Draw the gegl node */
     cairo_save(cr);
-    view_helper_draw(priv, cr, rect);
+    view_helper_draw_region(priv, cr, region);
     cairo_restore(cr);
 
 #ifdef HAVE_CAIRO_GOBJECT
     /* Draw overlay */
     cairo_save(cr);
     g_signal_emit(G_OBJECT(self), gegl_view_signals[SIGNAL_DRAW_OVERLAY],
-                  0, cr, rect, NULL);
+                  0, cr, &rect, NULL);
     cairo_restore(cr);
 #endif
 }
 
 #ifdef HAVE_GTK3
+/* Get the clip of @cr as a region, in user coordinates */
+static cairo_region_t *
+get_clip_region(cairo_t *cr)
+{
+    cairo_rectangle_list_t *list;
+    cairo_region_t *region;
+    GdkRectangle rect;
+    gint i;
+
+    list = cairo_copy_clip_rectangle_list(cr);
+    if (list->status != CAIRO_STATUS_SUCCESS) {
+        /* Clip is not made of rectangles, fall back to the bounding box */
+        cairo_rectangle_list_destroy(list);
+        if (!gdk_cairo_get_clip_rectangle(cr, &rect))
+            return cairo_region_create();
+        return cairo_region_create_rectangle((cairo_rectangle_int_t *)&rect);
+    }
+
+    region = cairo_region_create();
+    for (i = 0; i < list->num_rectangles; i++) {
+        cairo_rectangle_t *r = &list->rectangles[i];
+
+        rect.x = floor(r->x);
+        rect.y = floor(r->y);
+        rect.width = ceil(r->x + r->width) - rect.x;
+        rect.height = ceil(r->y + r->height) - rect.y;
+        cairo_region_union_rectangle(region, (cairo_rectangle_int_t *)&rect);
+    }
+    cairo_rectangle_list_destroy(list);
+
+    return region;
+}
+
 static gboolean
 draw(GtkWidget *widget, cairo_t *cr)
 {
     GeglGtkView *self = GEGL_GTK_VIEW(widget);
     ViewHelper *priv = GET_PRIVATE(self);
-    GdkRectangle rect;
+    cairo_region_t *region;
 
     if (!priv->node)
         return FALSE;
 
-    gdk_cairo_get_clip_rectangle(cr, &rect);
-
-    draw_implementation(self, cr, &rect);
+    region = get_clip_region(cr);
+    if (!cairo_region_is_empty(region))
+        draw_implementation(self, cr, region);
+    cairo_region_destroy(region);
 
     return FALSE;
 }
@@ -430,7 +811,9 @@ expose_event(GtkWidget      *widget,
     GeglGtkView *self = GEGL_GTK_VIEW(widget);
     ViewHelper *priv = GET_PRIVATE(self);
     cairo_t      *cr;
-    GdkRectangle rect;
+    cairo_region_t *region;
+    GdkRectangle *rects;
+    gint          n_rects, i;
 
     if (!priv->node)
         return FALSE;
@@ -438,10 +821,16 @@ expose_event(GtkWidget      *widget,
     cr = gdk_cairo_create(widget->window);
     gdk_cairo_region(cr, event->region);
     cairo_clip(cr);
-    gdk_region_get_clipbox(event->region, &rect);
 
-    draw_implementation(self, cr, &rect);
+    region = cairo_region_create();
+    gdk_region_get_rectangles(event->region, &rects, &n_rects);
+    for (i = 0; i < n_rects; i++)
+        cairo_region_union_rectangle(region, (cairo_rectangle_int_t *)&rects[i]);
+    g_free(rects);
 
+    draw_implementation(self, cr, region);
+
+    cairo_region_destroy(region);
     cairo_destroy(cr);
 
     return FALSE;
@@ -520,7 +909,8 @@ gegl_gtk_view_get_node(GeglGtkView *self)
  * @self: A #GeglGtkView
  * @scale:
  *
- * Setter for the :scale property
+ * Setter for the :scale property.
+ * Values outside of the range of the property are clamped to it.
  **/
 void
 gegl_gtk_view_set_scale(GeglGtkView *self, float scale)
@@ -596,6 +986,23 @@ gegl_gtk_view_get_y(GeglGtkView *self)
     return view_helper_get_y(GET_PRIVATE(self));
 }
 
+/**
+ * gegl_gtk_view_set_transform:
+ * @self: A #GeglGtkView
+ * @x: Offset of the view in the x direction
+ * @y: Offset of the view in the y direction
+ * @scale: Scale of the view, clamped to the range of the :scale property
+ *
+ * Set :x, :y and :scale in one go.
+ * Unlike calling the individual setters in sequence, this redraws
+ * the view once, and emits #GeglGtkView::transformation-changed once.
+ **/
+void
+gegl_gtk_view_set_transform(GeglGtkView *self, float x, float y, float scale)
+{
+    view_helper_set_transform(GET_PRIVATE(self), x, y, scale);
+}
+
 /**
  * gegl_gtk_view_get_transformation:
  * @self: A #GeglGtkView
@@ -639,3 +1046,62 @@ gegl_gtk_view_get_autoscale_policy(GeglGtkView *self)
 {
     return view_helper_get_autoscale_policy(GET_PRIVATE(self));
 }
+
+/**
+ * gegl_gtk_view_lock_graph:
+ * @self: A #GeglGtkView
+ *
+ * Keep the view from accessing the graph, so that it can be modified.
+ * With :threaded set, the graph is processed in a worker thread, and all
+ * modifications of the graph must be done between this and
+ * gegl_gtk_view_unlock_graph(). This includes changing properties of
+ * nodes, linking nodes and appending to a #GeglPath used in the graph.
+ * Waits for the worker to finish the piece it is working on.
+ *
+ * Must only be called from the main thread. Calls can be nested.
+ **/
+void
+gegl_gtk_view_lock_graph(GeglGtkView *self)
+{
+    view_helper_lock_graph(GET_PRIVATE(self));
+}
+
+/**
+ * gegl_gtk_view_unlock_graph:
+ * @self: A #GeglGtkView
+ *
+ * Let the view access the graph again, after gegl_gtk_view_lock_graph()
+ **/
+void
+gegl_gtk_view_unlock_graph(GeglGtkView *self)
+{
+    view_helper_unlock_graph(GET_PRIVATE(self));
+}
+
+/**
+ * gegl_gtk_view_get_stats:
+ * @self: A #GeglGtkView
+ * @stats: (out caller-allocates): Location to store the statistics in
+ *
+ * Get the runtime statistics of the view, for instance to log
+ * what drawing and processing the node costs.
+ **/
+void
+gegl_gtk_view_get_stats(GeglGtkView *self, GeglGtkViewStats *stats)
+{
+    view_helper_get_stats(GET_PRIVATE(self), stats);
+}
+
+/**
+ * gegl_gtk_view_reset_stats:
+ * @self: A #GeglGtkView
+ *
+ * Reset the counters of the statistics to zero.
+ * The queue length, progress and staging bytes are not counters,
+ * and keep reflecting the current state.
+ **/
+void
+gegl_gtk_view_reset_stats(GeglGtkView *self)
+{
+    view_helper_reset_stats(GET_PRIVATE(self));
+}
@@ -50,7 +50,34 @@ struct _GeglGtkViewClass {
     GtkDrawingAreaClass parent_class;
 };
 
+/**
+ * GeglGtkViewStats:
+ * @exposes: Number of times the view was drawn
+ * @pixels_blitted: Number of pixels fetched from the node with gegl_node_blit()
+ * @blit_time: Time spent in gegl_node_blit(), in microseconds
+ * @process_time: Time spent in gegl_processor_work(), in microseconds
+ * @queue_length: Number of rectangles waiting to be processed
+ * @progress: Progress processing the current rectangle, from 0.0 to 1.0
+ * @staging_bytes: Memory held by the surfaces tiles are rendered into, in bytes.
+ *   Counts both those kept in the tile cache and unused ones kept for reuse
+ *
+ * Runtime statistics of a #GeglGtkView, see gegl_gtk_view_get_stats().
+ * The counters accumulate until gegl_gtk_view_reset_stats() is called.
+ **/
+typedef struct {
+    guint64 exposes;
+    guint64 pixels_blitted;
+    guint64 blit_time;
+    guint64 process_time;
+    guint   queue_length;
+    gdouble progress;
+    gsize   staging_bytes;
+} GeglGtkViewStats;
+
+#define GEGL_GTK_TYPE_VIEW_STATS (gegl_gtk_view_stats_get_type())
+
 GType           gegl_gtk_view_get_type(void) G_GNUC_CONST;
+GType           gegl_gtk_view_stats_get_type(void) G_GNUC_CONST;
 
 
 GeglGtkView *gegl_gtk_view_new(void);
@@ -69,11 +96,18 @@ float gegl_gtk_view_get_x(GeglGtkView *self);
 void gegl_gtk_view_set_y(GeglGtkView *self, float y);
 float gegl_gtk_view_get_y(GeglGtkView *self);
 
+void gegl_gtk_view_set_transform(GeglGtkView *self, float x, float y, float scale);
 void gegl_gtk_view_get_transformation(GeglGtkView *self, GeglMatrix3 *matrix);
 
 void gegl_gtk_view_set_autoscale_policy(GeglGtkView *self, GeglGtkViewAutoscale autoscale);
 GeglGtkViewAutoscale gegl_gtk_view_get_autoscale_policy(GeglGtkView *self);
 
+void gegl_gtk_view_lock_graph(GeglGtkView *self);
+void gegl_gtk_view_unlock_graph(GeglGtkView *self);
+
+void gegl_gtk_view_get_stats(GeglGtkView *self, GeglGtkViewStats *stats);
+void gegl_gtk_view_reset_stats(GeglGtkView *self);
+
 G_END_DECLS
 
 #endif /* __GEGL_GTK_VIEW_H__ */
@@ -0,0 +1,202 @@
+/* This file is part of GEGL-GTK
+ *
+ * GEGL-GTK is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * GEGL-GTK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GEGL-GTK; if not, see <http://www.gnu.org/licenses/>.
+ *
+ * Copyright (C) 2026 The GEGL-GTK authors
+ */
+
+#include "surface-pool.h"
+
+/*
+ * Pool of cairo-ARGB32 image surfaces used as staging buffers for blitting.
+ *
+ * Requested sizes are rounded up to a size class, so that surfaces can be
+ * reused for similar sizes. In steady state drawing then does not allocate.
+ * Surfaces handed out may be larger than requested, and their contents
+ * are undefined. The pool can be used from several threads at once.
+ *
+ * The pool also keeps count of the memory of every surface it handed out
+ * that is still alive, such as those held by the tile cache.
+ */
+
+/* Surface dimensions are rounded up to a multiple of this */
+#define SIZE_CLASS_STEP 64
+
+struct _SurfacePool {
+    GMutex      mutex;
+    GHashTable *free_lists; /* size class -> GSList of unused surfaces */
+    gsize       max_bytes;
+    gsize       bytes;      /* Held by unused surfaces */
+    gsize       total_bytes; /* Held by all surfaces from the pool, in use or not */
+    guint       allocations;
+};
+
+/* Marks the surfaces allocated by a pool, with the pool as data */
+static cairo_user_data_key_t pool_key;
+
+
+static gint
+size_class(gint size)
+{
+    return MAX(1, (size + SIZE_CLASS_STEP - 1) / SIZE_CLASS_STEP) * SIZE_CLASS_STEP;
+}
+
+static gpointer
+size_class_key(gint width, gint height)
+{
+    return GUINT_TO_POINTER(((guint)width << 16) | (guint)height);
+}
+
+static gsize
+surface_bytes(cairo_surface_t *surface)
+{
+    return (gsize)cairo_image_surface_get_stride(surface) *
+           cairo_image_surface_get_height(surface);
+}
+
+static void
+free_list_destroy(gpointer data)
+{
+    g_slist_free_full(data, (GDestroyNotify) cairo_surface_destroy);
+}
+
+SurfacePool *
+surface_pool_new(gsize max_bytes)
+{
+    SurfacePool *pool = g_new0(SurfacePool, 1);
+
+    pool->free_lists = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+                                             NULL, free_list_destroy);
+    pool->max_bytes = max_bytes;
+    pool->bytes = 0;
+    pool->total_bytes = 0;
+    pool->allocations = 0;
+    g_mutex_init(&pool->mutex);
+
+    return pool;
+}
+
+void
+surface_pool_free(SurfacePool *pool)
+{
+    g_hash_table_destroy(pool->free_lists);
+    g_mutex_clear(&pool->mutex);
+    g_free(pool);
+}
+
+/* Returns: (transfer full): a surface of at least @width x @height pixels */
+cairo_surface_t *
+surface_pool_acquire(SurfacePool *pool, gint width, gint height)
+{
+    gint class_width = size_class(width);
+    gint class_height = size_class(height);
+    gpointer key = size_class_key(class_width, class_height);
+    GSList *free_list;
+    cairo_surface_t *surface;
+
+    g_mutex_lock(&pool->mutex);
+    free_list = g_hash_table_lookup(pool->free_lists, key);
+    if (free_list) {
+        surface = free_list->data;
+        g_hash_table_steal(pool->free_lists, key);
+        free_list = g_slist_delete_link(free_list, free_list);
+        if (free_list)
+            g_hash_table_insert(pool->free_lists, key, free_list);
+
+        pool->bytes -= surface_bytes(surface);
+        g_mutex_unlock(&pool->mutex);
+        return surface;
+    }
+
+    surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, class_width, class_height);
+    cairo_surface_set_user_data(surface, &pool_key, pool, NULL);
+    pool->allocations++;
+    pool->total_bytes += surface_bytes(surface);
+    g_mutex_unlock(&pool->mutex);
+    return surface;
+}
+
+/* Give a surface back to the pool, taking over the reference.
+ * Surfaces still in use elsewhere, not from this pool, or which do not fit,
+ * are just unreferenced. */
+void
+surface_pool_release(SurfacePool *pool, cairo_surface_t *surface)
+{
+    gint width = cairo_image_surface_get_width(surface);
+    gint height = cairo_image_surface_get_height(surface);
+    gsize bytes = surface_bytes(surface);
+    gpointer key;
+    GSList *free_list;
+
+    if (cairo_surface_get_user_data(surface, &pool_key) != pool) {
+        cairo_surface_destroy(surface);
+        return;
+    }
+
+    g_mutex_lock(&pool->mutex);
+    if (cairo_surface_get_reference_count(surface) > 1 ||
+            width != size_class(width) || height != size_class(height) ||
+            pool->bytes + bytes > pool->max_bytes) {
+        /* No longer accounted for, even if kept alive elsewhere */
+        pool->total_bytes -= bytes;
+        g_mutex_unlock(&pool->mutex);
+        cairo_surface_destroy(surface);
+        return;
+    }
+
+    key = size_class_key(width, height);
+    free_list = g_hash_table_lookup(pool->free_lists, key);
+    g_hash_table_steal(pool->free_lists, key);
+    g_hash_table_insert(pool->free_lists, key, g_slist_prepend(free_list, surface));
+
+    pool->bytes += bytes;
+    g_mutex_unlock(&pool->mutex);
+}
+
+/* Number of surfaces allocated over the lifetime of the pool */
+guint
+surface_pool_get_allocations(SurfacePool *pool)
+{
+    guint allocations;
+
+    g_mutex_lock(&pool->mutex);
+    allocations = pool->allocations;
+    g_mutex_unlock(&pool->mutex);
+    return allocations;
+}
+
+/* Memory held by surfaces waiting to be reused */
+gsize
+surface_pool_get_bytes(SurfacePool *pool)
+{
+    gsize bytes;
+
+    g_mutex_lock(&pool->mutex);
+    bytes = pool->bytes;
+    g_mutex_unlock(&pool->mutex);
+    return bytes;
+}
+
+/* Memory held by all surfaces handed out by the pool and not released
+ * for good, whether in use or waiting to be reused */
+gsize
+surface_pool_get_total_bytes(SurfacePool *pool)
+{
+    gsize bytes;
+
+    g_mutex_lock(&pool->mutex);
+    bytes = pool->total_bytes;
+    g_mutex_unlock(&pool->mutex);
+    return bytes;
+}
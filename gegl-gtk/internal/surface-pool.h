@@ -0,0 +1,44 @@
+/* This file is part of GEGL-GTK
+ *
+ * GEGL-GTK is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * GEGL-GTK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GEGL-GTK; if not, see <http://www.gnu.org/licenses/>.
+ *
+ * Copyright (C) 2026 The GEGL-GTK authors
+ */
+
+#ifndef __SURFACE_POOL_H__
+#define __SURFACE_POOL_H__
+
+#include <glib.h>
+#include <cairo.h>
+
+G_BEGIN_DECLS
+
+/* Upper bound on the memory held by unused surfaces, 32 MiB */
+#define SURFACE_POOL_MAX_BYTES (32 * 1024 * 1024)
+
+typedef struct _SurfacePool SurfacePool;
+
+SurfacePool *surface_pool_new(gsize max_bytes);
+void surface_pool_free(SurfacePool *pool);
+
+cairo_surface_t *surface_pool_acquire(SurfacePool *pool, gint width, gint height);
+void surface_pool_release(SurfacePool *pool, cairo_surface_t *surface);
+
+guint surface_pool_get_allocations(SurfacePool *pool);
+gsize surface_pool_get_bytes(SurfacePool *pool);
+gsize surface_pool_get_total_bytes(SurfacePool *pool);
+
+G_END_DECLS
+
+#endif /* __SURFACE_POOL_H__ */
@@ -0,0 +1,208 @@
+/* This file is part of GEGL-GTK
+ *
+ * GEGL-GTK is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * GEGL-GTK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GEGL-GTK; if not, see <http://www.gnu.org/licenses/>.
+ *
+ * Copyright (C) 2026 The GEGL-GTK authors
+ */
+
+#include "tile-cache.h"
+
+#include <math.h>
+
+/*
+ * Cache of rendered view tiles.
+ *
+ * Tiles hold pixels that have already been converted to cairo-ARGB32,
+ * and are keyed by (scale, tile x, tile y). Tile coordinates are in
+ * scaled model space, that is view space without the x/y translation,
+ * so that panning keeps hitting the same tiles.
+ */
+
+typedef struct {
+    gdouble scale;
+    gint    x;
+    gint    y;
+} TileCacheKey;
+
+typedef struct {
+    TileCacheKey     key;
+    cairo_surface_t *surface;
+    SurfacePool     *pool;    /* Evicted surfaces go back here */
+    GQueue          *lru;     /* The queue @link is in */
+    GList            link;    /* In TileCache.lru, with the entry as data */
+} TileCacheEntry;
+
+struct _TileCache {
+    GHashTable *tiles;
+    SurfacePool *pool;
+    guint       max_tiles;
+    GQueue      lru; /* TileCacheEntry, most recently used first */
+};
+
+
+static guint
+key_hash(gconstpointer v)
+{
+    const TileCacheKey *key = v;
+
+    /* Unsigned, as large tile indices overflow the multiplication */
+    return g_double_hash(&key->scale) ^ ((guint)key->x * 73856093u) ^ ((guint)key->y * 19349663u);
+}
+
+static gboolean
+key_equal(gconstpointer a, gconstpointer b)
+{
+    const TileCacheKey *ka = a;
+    const TileCacheKey *kb = b;
+
+    return ka->scale == kb->scale && ka->x == kb->x && ka->y == kb->y;
+}
+
+static void
+entry_free(gpointer data)
+{
+    TileCacheEntry *entry = data;
+
+    g_queue_unlink(entry->lru, &entry->link);
+    surface_pool_release(entry->pool, entry->surface);
+    g_free(entry);
+}
+
+/* The area in model coordinates that a tile was rendered from */
+static void
+entry_model_rect(TileCacheEntry *entry, GeglRectangle *rect)
+{
+    const gdouble tile_size = TILE_CACHE_TILE_SIZE;
+    const gdouble scale = entry->key.scale;
+    gdouble x1 = floor(entry->key.x * tile_size / scale);
+    gdouble y1 = floor(entry->key.y * tile_size / scale);
+    gdouble x2 = ceil((entry->key.x + 1) * tile_size / scale);
+    gdouble y2 = ceil((entry->key.y + 1) * tile_size / scale);
+
+    /* Grow by one pixel, resampling reads from neighbouring pixels */
+    rect->x = x1 - 1;
+    rect->y = y1 - 1;
+    rect->width = x2 - x1 + 2;
+    rect->height = y2 - y1 + 2;
+}
+
+static gboolean
+entry_intersects(gpointer key, gpointer value, gpointer user_data)
+{
+    const GeglRectangle *model_rect = user_data;
+    GeglRectangle tile_rect;
+
+    entry_model_rect(value, &tile_rect);
+    return gegl_rectangle_intersect(NULL, &tile_rect, model_rect);
+}
+
+static void
+evict_oldest(TileCache *cache)
+{
+    TileCacheEntry *oldest = g_queue_peek_tail(&cache->lru);
+
+    if (oldest)
+        g_hash_table_remove(cache->tiles, &oldest->key);
+}
+
+/* Surfaces of evicted tiles are released to @pool, for reuse */
+TileCache *
+tile_cache_new(guint max_tiles, SurfacePool *pool)
+{
+    TileCache *cache = g_new0(TileCache, 1);
+
+    cache->pool = pool;
+    cache->tiles = g_hash_table_new_full(key_hash, key_equal, NULL, entry_free);
+    cache->max_tiles = max_tiles;
+    g_queue_init(&cache->lru);
+
+    return cache;
+}
+
+void
+tile_cache_free(TileCache *cache)
+{
+    g_hash_table_destroy(cache->tiles);
+    g_free(cache);
+}
+
+/* Returns: (transfer none): the cached tile, or NULL on a cache miss */
+cairo_surface_t *
+tile_cache_lookup(TileCache *cache, gdouble scale, gint x, gint y)
+{
+    TileCacheKey key = { scale, x, y };
+    TileCacheEntry *entry = g_hash_table_lookup(cache->tiles, &key);
+
+    if (!entry)
+        return NULL;
+
+    g_queue_unlink(&cache->lru, &entry->link);
+    g_queue_push_head_link(&cache->lru, &entry->link);
+    return entry->surface;
+}
+
+/* Add a tile to the cache, taking a reference to @surface.
+ * Evicts the least recently used tile if the cache is full. */
+void
+tile_cache_insert(TileCache *cache, gdouble scale, gint x, gint y,
+                  cairo_surface_t *surface)
+{
+    TileCacheEntry *entry;
+
+    while (g_hash_table_size(cache->tiles) > 0 &&
+            g_hash_table_size(cache->tiles) >= cache->max_tiles)
+        evict_oldest(cache);
+
+    entry = g_new(TileCacheEntry, 1);
+    entry->key.scale = scale;
+    entry->key.x = x;
+    entry->key.y = y;
+    entry->surface = cairo_surface_reference(surface);
+    entry->pool = cache->pool;
+    entry->lru = &cache->lru;
+    entry->link.data = entry;
+    entry->link.prev = NULL;
+    entry->link.next = NULL;
+
+    /* Replacing an entry unlinks the previous one */
+    g_hash_table_replace(cache->tiles, &entry->key, entry);
+    g_queue_push_head_link(&cache->lru, &entry->link);
+}
+
+void
+tile_cache_remove(TileCache *cache, gdouble scale, gint x, gint y)
+{
+    TileCacheKey key = { scale, x, y };
+
+    g_hash_table_remove(cache->tiles, &key);
+}
+
+/* Drop all tiles, at any scale, which were rendered from pixels in @model_rect */
+void
+tile_cache_invalidate(TileCache *cache, const GeglRectangle *model_rect)
+{
+    g_hash_table_foreach_remove(cache->tiles, entry_intersects, (gpointer)model_rect);
+}
+
+void
+tile_cache_clear(TileCache *cache)
+{
+    g_hash_table_remove_all(cache->tiles);
+}
+
+guint
+tile_cache_get_size(TileCache *cache)
+{
+    return g_hash_table_size(cache->tiles);
+}
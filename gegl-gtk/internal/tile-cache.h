@@ -0,0 +1,53 @@
+/* This file is part of GEGL-GTK
+ *
+ * GEGL-GTK is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * GEGL-GTK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GEGL-GTK; if not, see <http://www.gnu.org/licenses/>.
+ *
+ * Copyright (C) 2026 The GEGL-GTK authors
+ */
+
+#ifndef __TILE_CACHE_H__
+#define __TILE_CACHE_H__
+
+#include <glib.h>
+#include <gegl.h>
+#include <cairo.h>
+
+#include "surface-pool.h"
+
+G_BEGIN_DECLS
+
+/* Size of a cached tile, in view pixels */
+#define TILE_CACHE_TILE_SIZE 128
+
+/* Upper bound on the number of tiles kept around, 64 MiB worth of pixels */
+#define TILE_CACHE_MAX_TILES 1024
+
+typedef struct _TileCache TileCache;
+
+TileCache *tile_cache_new(guint max_tiles, SurfacePool *pool);
+void tile_cache_free(TileCache *cache);
+
+cairo_surface_t *tile_cache_lookup(TileCache *cache, gdouble scale, gint x, gint y);
+void tile_cache_insert(TileCache *cache, gdouble scale, gint x, gint y,
+                       cairo_surface_t *surface);
+
+void tile_cache_remove(TileCache *cache, gdouble scale, gint x, gint y);
+void tile_cache_invalidate(TileCache *cache, const GeglRectangle *model_rect);
+void tile_cache_clear(TileCache *cache);
+
+guint tile_cache_get_size(TileCache *cache);
+
+G_END_DECLS
+
+#endif /* __TILE_CACHE_H__ */
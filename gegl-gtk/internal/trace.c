@@ -0,0 +1,145 @@
+/* This file is part of GEGL-GTK
+ *
+ * GEGL-GTK is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * GEGL-GTK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GEGL-GTK; if not, see <http://www.gnu.org/licenses/>.
+ *
+ * Copyright (C) 2026 The GEGL-GTK authors
+ */
+
+#include "trace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <glib/gstdio.h>
+
+/*
+ * Timeline of drawing and processing, for diagnosing jank.
+ *
+ * Enabled by setting GEGL_GTK_TRACE to a file name. Events are written
+ * in the Chrome trace event format, which opens in chrome://tracing,
+ * Perfetto and other trace viewers. Timestamps are monotonic time in
+ * microseconds. Each thread gets a small id of its own.
+ *
+ * The JSON array is closed at exit. Should the process not exit
+ * cleanly, the trace can still be loaded, as the format allows
+ * leaving the array open.
+ */
+
+static FILE    *trace_file = NULL;
+static gboolean trace_first = TRUE;
+static GMutex   trace_mutex;
+static gint     trace_next_tid = 0;
+static GPrivate trace_tid = G_PRIVATE_INIT(NULL);
+
+static void
+trace_close(void)
+{
+    g_mutex_lock(&trace_mutex);
+    fputs("\n]\n", trace_file);
+    fclose(trace_file);
+    trace_file = NULL;
+    g_mutex_unlock(&trace_mutex);
+}
+
+gboolean
+trace_enabled(void)
+{
+    static gsize initialized = 0;
+
+    if (g_once_init_enter(&initialized)) {
+        const gchar *path = g_getenv(TRACE_ENV);
+
+        if (path && path[0] != '\0') {
+            trace_file = g_fopen(path, "w");
+            if (trace_file) {
+                fputs("[\n", trace_file);
+                atexit(trace_close);
+            } else {
+                g_warning("Could not open trace file %s", path);
+            }
+        }
+        g_once_init_leave(&initialized, 1);
+    }
+
+    return trace_file != NULL;
+}
+
+static gint
+get_tid(void)
+{
+    gint tid = GPOINTER_TO_INT(g_private_get(&trace_tid));
+
+    if (tid == 0) {
+        tid = g_atomic_int_add(&trace_next_tid, 1) + 1;
+        g_private_set(&trace_tid, GINT_TO_POINTER(tid));
+    }
+    return tid;
+}
+
+/* Write an event, @fields being the event specific members */
+static void
+write_event(const gchar *name, const gchar *fields, const GeglRectangle *rect)
+{
+    gchar *args = rect ?
+                  g_strdup_printf(", \"args\": {\"x\": %d, \"y\": %d, \"width\": %d, \"height\": %d}",
+                                  rect->x, rect->y, rect->width, rect->height) :
+                  g_strdup("");
+    gint tid = get_tid();
+
+    g_mutex_lock(&trace_mutex);
+    if (trace_file) {
+        fprintf(trace_file, "%s{\"name\": \"%s\", \"cat\": \"gegl-gtk\", %s, \"pid\": 1, \"tid\": %d%s}",
+                trace_first ? "" : ",\n", name, fields, tid, args);
+        trace_first = FALSE;
+    }
+    g_mutex_unlock(&trace_mutex);
+
+    g_free(args);
+}
+
+/* Returns: the start time for trace_span(), or 0 if tracing is disabled */
+gint64
+trace_begin(void)
+{
+    return trace_enabled() ? g_get_monotonic_time() : 0;
+}
+
+/* Record a span from @start until now, with @rect as argument if not NULL */
+void
+trace_span(const gchar *name, gint64 start, const GeglRectangle *rect)
+{
+    gchar *fields;
+
+    if (!trace_enabled())
+        return;
+
+    fields = g_strdup_printf("\"ph\": \"X\", \"ts\": %" G_GINT64_FORMAT ", \"dur\": %" G_GINT64_FORMAT,
+                             start, g_get_monotonic_time() - start);
+    write_event(name, fields, rect);
+    g_free(fields);
+}
+
+/* Record an event at the current time */
+void
+trace_instant(const gchar *name, const GeglRectangle *rect)
+{
+    gchar *fields;
+
+    if (!trace_enabled())
+        return;
+
+    fields = g_strdup_printf("\"ph\": \"i\", \"s\": \"t\", \"ts\": %" G_GINT64_FORMAT,
+                             g_get_monotonic_time());
+    write_event(name, fields, rect);
+    g_free(fields);
+}
@@ -0,0 +1,38 @@
+/* This file is part of GEGL-GTK
+ *
+ * GEGL-GTK is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * GEGL-GTK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GEGL-GTK; if not, see <http://www.gnu.org/licenses/>.
+ *
+ * Copyright (C) 2026 The GEGL-GTK authors
+ */
+
+#ifndef __TRACE_H__
+#define __TRACE_H__
+
+#include <glib.h>
+#include <gegl.h>
+
+G_BEGIN_DECLS
+
+/* Environment variable with the file to write the trace to */
+#define TRACE_ENV "GEGL_GTK_TRACE"
+
+gboolean trace_enabled(void);
+
+gint64 trace_begin(void);
+void trace_span(const gchar *name, gint64 start, const GeglRectangle *rect);
+void trace_instant(const gchar *name, const GeglRectangle *rect);
+
+G_END_DECLS
+
+#endif /* __TRACE_H__ */
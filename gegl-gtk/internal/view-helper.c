@@ -18,6 +18,8 @@
  */
 
 #include "view-helper.h"
+#include "gegl-gtk-marshal.h"
+#include "trace.h"
 
 #include <math.h>
 #include <babl/babl.h>
@@ -25,22 +27,60 @@
 
 G_DEFINE_TYPE(ViewHelper, view_helper, G_TYPE_OBJECT)
 
+/* Default time spent processing per main loop iteration, half a frame at 60 Hz */
+#define DEFAULT_PROCESSING_BUDGET 8000
+
+/* Size of the pieces the dirty region is processed in, in model pixels */
+#define PROCESSING_TILE_SIZE 256
+
+/* In progressive mode, dirty areas are first processed and shown at
+ * 1/PROGRESSIVE_FACTOR of the view resolution. Must be a power of two
+ * that divides TILE_CACHE_TILE_SIZE */
+#define PROGRESSIVE_FACTOR 8
+
+/* Transform changes closer together than this, in microseconds,
+ * make the view interactive */
+#define INTERACTIVE_INTERVAL 100000
+
+/* The view stops being interactive after this many milliseconds
+ * without transform changes */
+#define INTERACTIVE_QUIET_PERIOD 250
+
+/* While interactive, tiles are rendered at 1/INTERACTIVE_FACTOR of the
+ * view resolution */
+#define INTERACTIVE_FACTOR 2
+
+/* Autoscaling ignores scale changes smaller than this fraction,
+ * so that small changes of the bounding box do not cause full redraws */
+#define AUTOSCALE_HYSTERESIS 0.01
+
 
 enum {
     SIGNAL_REDRAW_NEEDED,
     SIGNAL_SIZE_CHANGED,
+    SIGNAL_SCROLL_NEEDED,
+    SIGNAL_INTERACTIVE_CHANGED,
+    SIGNAL_TRANSFORMATION_CHANGED,
     N_SIGNALS
 };
 
 static guint view_helper_signals[N_SIGNALS] = { 0 };
 
 
+static void
+dispose(GObject *gobject);
 static void
 finalize(GObject *gobject);
 void
 trigger_processing(ViewHelper *self, GeglRectangle roi);
 void
 trigger_redraw(ViewHelper *self, GeglRectangle *redraw_rect);
+static void
+process_deferred(ViewHelper *self);
+static void
+update_levels(ViewHelper *self);
+static void
+schedule_results(ViewHelper *self);
 
 
 static void
@@ -48,6 +88,7 @@ view_helper_class_init(ViewHelperClass *klass)
 {
     GObjectClass *gobject_class = G_OBJECT_CLASS(klass);
 
+    gobject_class->dispose = dispose;
     gobject_class->finalize = finalize;
 
     /* Emitted when a redraw is needed, with the area that needs redrawing. */
@@ -69,49 +110,234 @@ view_helper_class_init(ViewHelperClass *klass)
             g_cclosure_marshal_VOID__BOXED,
             G_TYPE_NONE, 1,
             GEGL_TYPE_RECTANGLE);
+
+    /* Emitted when the view was translated, with the distance in view pixels.
+     * The pixels already on screen can be moved by (-dx, -dy), and only
+     * the newly exposed areas need to be drawn. */
+    view_helper_signals[SIGNAL_SCROLL_NEEDED] = g_signal_new("scroll-needed",
+            G_TYPE_FROM_CLASS(klass),
+            G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION,
+            0,
+            NULL, NULL,
+            gegl_gtk_marshal_VOID__INT_INT,
+            G_TYPE_NONE, 2,
+            G_TYPE_INT, G_TYPE_INT);
+
+    /* Emitted when x, y or scale changed, once for view_helper_set_transform() */
+    view_helper_signals[SIGNAL_TRANSFORMATION_CHANGED] = g_signal_new("transformation-changed",
+            G_TYPE_FROM_CLASS(klass),
+            G_SIGNAL_RUN_LAST,
+            0,
+            NULL, NULL,
+            g_cclosure_marshal_VOID__VOID,
+            G_TYPE_NONE, 0);
+
+    /* Emitted when the view enters or leaves the interactive state */
+    view_helper_signals[SIGNAL_INTERACTIVE_CHANGED] = g_signal_new("interactive-changed",
+            G_TYPE_FROM_CLASS(klass),
+            G_SIGNAL_RUN_LAST,
+            0,
+            NULL, NULL,
+            g_cclosure_marshal_VOID__BOOLEAN,
+            G_TYPE_NONE, 1,
+            G_TYPE_BOOLEAN);
 }
 
 static void
 view_helper_init(ViewHelper *self)
 {
     GdkRectangle invalid_gdkrect = {0, 0, -1, -1};
+    gint i;
 
     self->node        = NULL;
     self->x           = 0;
     self->y           = 0;
     self->scale       = 1.0;
     self->autoscale_policy = GEGL_GTK_VIEW_AUTOSCALE_CONTENT;
+    self->bbox_valid = FALSE;
+    self->autoscale_size_valid = FALSE;
+    self->filter = GEGL_GTK_VIEW_FILTER_NEAREST;
     self->block = FALSE;
 
     self->monitor_id  = 0;
+    self->processing_priority = G_PRIORITY_LOW;
+    self->processing_budget = DEFAULT_PROCESSING_BUDGET;
     self->processor = NULL;
-    self->processing_queue = g_queue_new();
+    self->processing_region = cairo_region_create();
     self->currently_processed_rect = NULL;
+    self->current_level = 0;
+    self->current_coarse = FALSE;
+    self->view_level = 0;
+    for (i = 0; i <= VIEW_HELPER_MAX_LEVEL; i++)
+        self->lod_region[i] = cairo_region_create();
+    self->progressive = FALSE;
+    self->coarse_queue = cairo_region_create();
+    self->coarse_region = cairo_region_create();
+    self->coarse_level = 0;
+    self->has_focus = FALSE;
+    self->focus_x = 0.0;
+    self->focus_y = 0.0;
+    self->has_pointer = FALSE;
+    self->pointer_x = 0.0;
+    self->pointer_y = 0.0;
+    self->deferred_region = cairo_region_create();
+    self->suspended = FALSE;
+    self->redraw_on_resume = FALSE;
 
     self->widget_allocation = invalid_gdkrect;
+    self->pause_when_hidden = TRUE;
+    self->widget_obscured = FALSE;
+    self->widget_iconified = FALSE;
+
+    self->surface_pool = surface_pool_new(SURFACE_POOL_MAX_BYTES);
+    self->tile_cache = tile_cache_new(TILE_CACHE_MAX_TILES, self->surface_pool);
+
+    self->main_thread = g_thread_self();
+    self->worker = NULL;
+    self->worker_quit = FALSE;
+    g_mutex_init(&self->queue_mutex);
+    g_cond_init(&self->queue_cond);
+    g_rec_mutex_init(&self->process_mutex);
+    g_mutex_init(&self->stats_mutex);
+    self->stats_exposes = 0;
+    self->stats_pixels_blitted = 0;
+    self->stats_blit_time = 0;
+    self->stats_process_time = 0;
+    self->progress = 0.0;
+    self->generation = 0;
+    self->computed_region = cairo_region_create();
+    self->results_id = 0;
+
+    self->drawn_scale = 0.0;
+    self->pending_region = cairo_region_create();
+    self->pending_id = 0;
+
+    self->interactive = FALSE;
+    self->interactive_explicit = FALSE;
+    self->interactive_auto = FALSE;
+    self->last_transform_time = 0;
+    self->interactive_id = 0;
+    self->transform_change_id = 0;
+    self->interactive_tiles = g_array_new(FALSE, FALSE, sizeof(InteractiveTile));
+
+    self->damage_region = cairo_region_create();
+    self->damage_all = FALSE;
+    self->damage_tick_id = 0;
+
+    update_levels(self);
+
+    self->render_threads = 0;
+    self->render_pool = NULL;
+    self->render_pending = 0;
+    g_mutex_init(&self->render_mutex);
+    g_cond_init(&self->render_cond);
+}
+
+static void
+stop_worker(ViewHelper *self)
+{
+    if (!self->worker)
+        return;
+
+    g_mutex_lock(&self->queue_mutex);
+    self->worker_quit = TRUE;
+    g_cond_signal(&self->queue_cond);
+    g_mutex_unlock(&self->queue_mutex);
+
+    g_thread_join(self->worker);
+    self->worker = NULL;
+    self->worker_quit = FALSE;
+}
+
+static void
+dispose(GObject *gobject)
+{
+    ViewHelper *self = VIEW_HELPER(gobject);
+
+    /* Must happen before the node signal handlers go away,
+     * the worker may be emitting "computed" */
+    stop_worker(self);
+
+    if (self->render_pool) {
+        g_thread_pool_free(self->render_pool, FALSE, TRUE);
+        self->render_pool = NULL;
+    }
+
+    G_OBJECT_CLASS(view_helper_parent_class)->dispose(gobject);
 }
 
 static void
 finalize(GObject *gobject)
 {
     ViewHelper *self = VIEW_HELPER(gobject);
+    gint i;
 
     if (self->monitor_id) {
         g_source_remove(self->monitor_id);
         self->monitor_id = 0;
     }
 
+    if (self->results_id) {
+        g_source_remove(self->results_id);
+        self->results_id = 0;
+    }
+
+    if (self->pending_id) {
+        g_source_remove(self->pending_id);
+        self->pending_id = 0;
+    }
+
+    if (self->interactive_id) {
+        g_source_remove(self->interactive_id);
+        self->interactive_id = 0;
+    }
+
+    if (self->transform_change_id) {
+        g_source_remove(self->transform_change_id);
+        self->transform_change_id = 0;
+    }
+
     if (self->node)
         g_object_unref(self->node);
 
     if (self->processor)
         g_object_unref(self->processor);
 
-    g_queue_free_full(self->processing_queue, g_free);
+    cairo_region_destroy(self->processing_region);
+    cairo_region_destroy(self->coarse_queue);
+    cairo_region_destroy(self->coarse_region);
+    for (i = 0; i <= VIEW_HELPER_MAX_LEVEL; i++)
+        cairo_region_destroy(self->lod_region[i]);
 
     if (self->currently_processed_rect) {
         g_free(self->currently_processed_rect);
     }
+
+    cairo_region_destroy(self->deferred_region);
+
+    tile_cache_free(self->tile_cache);
+    surface_pool_free(self->surface_pool);
+
+    cairo_region_destroy(self->computed_region);
+    cairo_region_destroy(self->pending_region);
+    g_array_free(self->interactive_tiles, TRUE);
+    cairo_region_destroy(self->damage_region);
+    g_mutex_clear(&self->queue_mutex);
+    g_cond_clear(&self->queue_cond);
+    g_rec_mutex_clear(&self->process_mutex);
+    g_mutex_clear(&self->stats_mutex);
+    g_mutex_clear(&self->render_mutex);
+    g_cond_clear(&self->render_cond);
+
+    G_OBJECT_CLASS(view_helper_parent_class)->finalize(gobject);
+}
+
+/* Convert a coordinate to an int, clamped to a range in which
+ * adding a width to it cannot overflow */
+static gint
+clamp_to_int(gdouble value)
+{
+    return (gint)CLAMP(value, G_MININT / 2, G_MAXINT / 2);
 }
 
 /* Transform a rectangle from model to view coordinates. */
@@ -120,14 +346,123 @@ model_rect_to_view_rect(ViewHelper *self, GeglRectangle *rect)
 {
     GeglRectangle temp;
 
-    temp.x = self->scale * (rect->x) - self->x;
-    temp.y = self->scale * (rect->y) - self->y;
-    temp.width = ceil(self->scale * rect->width);
-    temp.height = ceil(self->scale * rect->height);
+    temp.x = clamp_to_int(self->scale * (rect->x) - self->x);
+    temp.y = clamp_to_int(self->scale * (rect->y) - self->y);
+    temp.width = clamp_to_int(ceil(self->scale * rect->width));
+    temp.height = clamp_to_int(ceil(self->scale * rect->height));
 
     *rect = temp;
 }
 
+/* Integer division rounding towards negative infinity */
+static gint
+floor_div(gint a, gint b)
+{
+    return (a >= 0) ? a / b : -((-a + b - 1) / b);
+}
+
+static void
+to_cairo_rectangle(const GeglRectangle *rect, cairo_rectangle_int_t *out)
+{
+    out->x = rect->x;
+    out->y = rect->y;
+    out->width = rect->width;
+    out->height = rect->height;
+}
+
+/* Get the area of the model which is visible in the view.
+ * Returns FALSE if it is not known, because the view has no allocation */
+static gboolean
+get_visible_model_rect(ViewHelper *self, GeglRectangle *rect)
+{
+    GdkRectangle viewport = self->widget_allocation;
+
+    if (viewport.width < 0 || viewport.height < 0 || self->scale <= 0.0)
+        return FALSE;
+
+    rect->x = clamp_to_int(floor(self->x / self->scale));
+    rect->y = clamp_to_int(floor(self->y / self->scale));
+    rect->width = clamp_to_int(ceil(viewport.width / self->scale) + 2);
+    rect->height = clamp_to_int(ceil(viewport.height / self->scale) + 2);
+
+    return TRUE;
+}
+
+/* Update the point that processing is prioritized around.
+ * This is the pointer if it is inside the view, otherwise the center of the view.
+ * Must be called whenever the transformation, allocation or pointer changes */
+static void
+update_focus(ViewHelper *self)
+{
+    GdkRectangle viewport = self->widget_allocation;
+    gboolean has_focus = TRUE;
+    gdouble view_x = 0.0, view_y = 0.0;
+
+    if (self->has_pointer) {
+        view_x = self->pointer_x;
+        view_y = self->pointer_y;
+    } else if (viewport.width >= 0 && viewport.height >= 0) {
+        view_x = viewport.width / 2.0;
+        view_y = viewport.height / 2.0;
+    } else {
+        has_focus = FALSE;
+    }
+
+    if (self->scale <= 0.0)
+        has_focus = FALSE;
+
+    g_mutex_lock(&self->queue_mutex);
+    self->has_focus = has_focus;
+    if (has_focus) {
+        self->focus_x = (view_x + self->x) / self->scale;
+        self->focus_y = (view_y + self->y) / self->scale;
+    }
+    g_mutex_unlock(&self->queue_mutex);
+}
+
+/* The GEGL level of detail which is read when blitting at @scale */
+static gint
+level_for_scale(gdouble scale)
+{
+    gint level = 0;
+
+    while (scale <= 0.5 && level < VIEW_HELPER_MAX_LEVEL) {
+        scale *= 2.0;
+        level++;
+    }
+
+    return level;
+}
+
+/* Update the levels of detail the node is processed at, for the view
+ * and for the coarse pass of progressive rendering.
+ * Must be called whenever the scale changes */
+static void
+update_levels(ViewHelper *self)
+{
+    g_mutex_lock(&self->queue_mutex);
+    self->view_level = level_for_scale(self->scale);
+    self->coarse_level = level_for_scale(self->scale / PROGRESSIVE_FACTOR);
+    g_mutex_unlock(&self->queue_mutex);
+}
+
+/* The bounding box of the node.
+ * Walking the graph for it is expensive on deep graphs, so it is cached
+ * until an invalidation could have changed it, see invalidated_event() */
+static GeglRectangle
+get_bounding_box(ViewHelper *self)
+{
+    if (!self->bbox_valid) {
+        /* Prepares the graph, which the worker may be processing */
+        g_rec_mutex_lock(&self->process_mutex);
+        self->bbox = gegl_node_get_bounding_box(self->node);
+        g_rec_mutex_unlock(&self->process_mutex);
+        self->bbox_valid = TRUE;
+    }
+
+    return self->bbox;
+}
+
 static void
 update_autoscale(ViewHelper *self)
 {
@@ -137,14 +472,20 @@ update_autoscale(ViewHelper *self)
     if (!self->node || viewport.width < 0 || viewport.height < 0)
         return;
 
-    bbox = gegl_node_get_bounding_box(self->node);
+    bbox = get_bounding_box(self);
     model_rect_to_view_rect(self, &bbox);
     if (bbox.width < 0 || bbox.height < 0)
         return;
 
     if (self->autoscale_policy == GEGL_GTK_VIEW_AUTOSCALE_WIDGET) {
-        /* Request widget size change */
+        /* Request widget size change, if the size did change */
         /* XXX: Should we reset scale/x/y here? */
+        if (self->autoscale_size_valid &&
+                gegl_rectangle_equal(&bbox, &self->autoscale_size))
+            return;
+
+        self->autoscale_size = bbox;
+        self->autoscale_size_valid = TRUE;
         g_signal_emit(self, view_helper_signals[SIGNAL_SIZE_CHANGED],
                       0, &bbox, NULL);
 
@@ -154,6 +495,9 @@ update_autoscale(ViewHelper *self)
         float height_ratio = bbox.height / (float)viewport.height;
         float max_ratio = width_ratio >= height_ratio ? width_ratio : height_ratio;
 
+        if (fabs(max_ratio - 1.0) < AUTOSCALE_HYSTERESIS)
+            return;
+
         float current_scale = view_helper_get_scale(self);
         view_helper_set_scale(self, current_scale * (1.0 / max_ratio));
     }
@@ -165,240 +509,1514 @@ invalidated_event(GeglNode      *node,
                   GeglRectangle *rect,
                   ViewHelper    *self)
 {
+    trace_instant("invalidated", rect);
+
+    /* Changes strictly inside the bounding box can not move its edges */
+    if (self->bbox_valid &&
+            !(rect->x > self->bbox.x && rect->y > self->bbox.y &&
+              rect->x + rect->width < self->bbox.x + self->bbox.width &&
+              rect->y + rect->height < self->bbox.y + self->bbox.height))
+        self->bbox_valid = FALSE;
+
+    tile_cache_invalidate(self->tile_cache, rect);
     trigger_processing(self, *rect);
 }
 
+/* Take the piece of @region to process next out of it.
+ * @region is processed in tiles of @tile_size, starting with the tile
+ * closest to the focus point.
+ * Returns FALSE if @region is empty. */
 static gboolean
-task_monitor(ViewHelper *self)
+take_rect_from(ViewHelper *self, cairo_region_t *region, gint tile_size,
+               cairo_rectangle_int_t *next)
 {
-    if (!self->processor || !self->node) {
+    gdouble best_distance = G_MAXDOUBLE;
+    gint i;
+
+    if (cairo_region_is_empty(region))
         return FALSE;
-    }
 
-    // PERFORMANCE: combine all the rects added to the queue during a single
-    // iteration of the main loop somehow
+    for (i = 0; i < cairo_region_num_rectangles(region); i++) {
+        cairo_rectangle_int_t r;
+        gint point_x, point_y, tile_x, tile_y, x1, y1, x2, y2;
+        gdouble dx, dy, distance;
+
+        cairo_region_get_rectangle(region, i, &r);
+
+        /* The point in the rectangle closest to the focus, and its tile */
+        if (self->has_focus) {
+            point_x = CLAMP((gint)floor(self->focus_x), r.x, r.x + r.width - 1);
+            point_y = CLAMP((gint)floor(self->focus_y), r.y, r.y + r.height - 1);
+            dx = point_x - self->focus_x;
+            dy = point_y - self->focus_y;
+            distance = dx * dx + dy * dy;
+        } else {
+            point_x = r.x;
+            point_y = r.y;
+            distance = 0.0;
+        }
 
-    if (!self->currently_processed_rect) {
+        if (distance >= best_distance)
+            continue;
 
-        if (g_queue_is_empty(self->processing_queue)) {
-            // Unregister worker
-            self->monitor_id = 0;
-            return FALSE;
-        }
-        else {
-            // Fetch next rect to process
-            self->currently_processed_rect = (GeglRectangle *)g_queue_pop_tail(self->processing_queue);
-            g_assert(self->currently_processed_rect);
-            gegl_processor_set_rectangle(self->processor, self->currently_processed_rect);
-        }
-    }
+        tile_x = floor_div(point_x, tile_size) * tile_size;
+        tile_y = floor_div(point_y, tile_size) * tile_size;
+        x1 = MAX(r.x, tile_x);
+        y1 = MAX(r.y, tile_y);
+        x2 = MIN(r.x + r.width, tile_x + tile_size);
+        y2 = MIN(r.y + r.height, tile_y + tile_size);
 
-    gboolean processing_done = !gegl_processor_work(self->processor, NULL);
+        next->x = x1;
+        next->y = y1;
+        next->width = x2 - x1;
+        next->height = y2 - y1;
+        best_distance = distance;
 
-    if (processing_done) {
-        // Go to next region
-        if (self->currently_processed_rect) {
-            g_free(self->currently_processed_rect);
-        }
-        self->currently_processed_rect = NULL;
+        if (!self->has_focus)
+            break;
     }
 
+    cairo_region_subtract_rectangle(region, next);
     return TRUE;
 }
 
-
-/* When the GeglNode has been computed,
- * find out if the size of the vie changed and
- * emit the "size-changed" signal to notify view
- * find out which area in the view was computed and emit the
- * "redraw-needed" signal to notify it that a redraw is needed */
-static void
-computed_event(GeglNode      *node,
-               GeglRectangle *rect,
-               ViewHelper    *self)
+/* Fetch the next rect to process, and take it out of the dirty region.
+ * The dirty region is processed one tile at a time, starting with the tile
+ * closest to the focus point, so that small changes near where the user is
+ * looking are not held up by large ones elsewhere. As the order is decided
+ * for each tile, it follows changes in the view transformation.
+ *
+ * In progressive mode, areas waiting for a coarse pass go first. Coarse
+ * tiles cover more model pixels, as only a fraction of them is computed.
+ * Like view tiles, their size follows the level of detail, so each one
+ * costs about the same whatever the scale.
+ *
+ * Must be called with queue_mutex held when the worker thread is running.
+ * Returns FALSE if there is nothing left to process. */
+static gboolean
+take_next_rect(ViewHelper *self)
 {
-    update_autoscale(self);
+    cairo_rectangle_int_t next;
 
-    /* Emit redraw-needed */
-    GeglRectangle redraw_rect = *rect;
-    model_rect_to_view_rect(self, &redraw_rect);
+    if (self->coarse_level <= self->view_level) {
+        /* Zoomed in too far for a coarse pass to save anything */
+        cairo_region_destroy(self->coarse_queue);
+        self->coarse_queue = cairo_region_create();
+    }
 
-    trigger_redraw(self, &redraw_rect);
-}
+    if (take_rect_from(self, self->coarse_queue,
+                       PROCESSING_TILE_SIZE << self->coarse_level, &next)) {
+        self->current_level = self->coarse_level;
+        self->current_coarse = TRUE;
+    } else if (take_rect_from(self, self->processing_region,
+                              PROCESSING_TILE_SIZE << self->view_level, &next)) {
+        /* Only as much detail as the view shows, see refine_lod() */
+        self->current_level = self->view_level;
+        self->current_coarse = FALSE;
+    } else {
+        return FALSE;
+    }
 
-ViewHelper *
-view_helper_new(void)
-{
-    return VIEW_HELPER(g_object_new(VIEW_HELPER_TYPE, NULL));
+    self->currently_processed_rect = g_new(GeglRectangle, 1);
+    gegl_rectangle_set(self->currently_processed_rect,
+                       next.x, next.y, next.width, next.height);
+    return TRUE;
 }
 
-/* Draw the view of the GeglNode to the provided cairo context,
- * taking into account transformations et.c.
- * @rect the bounding box of the area to draw in view coordinates
+/* Called when the processor is done with currently_processed_rect.
+ * Keeps track of which areas only have coarse results so far, and of
+ * the level of detail the other areas were processed at. Makes sure
+ * the affected tiles are drawn again.
  *
- * For instance called by widget during the draw/expose */
-void
-view_helper_draw(ViewHelper *self, cairo_t *cr, GdkRectangle *rect)
+ * Must be called with queue_mutex held when the worker thread is running. */
+static void
+finish_rect(ViewHelper *self)
 {
-    cairo_surface_t *surface = NULL;
-    guchar          *buf = NULL;
-    GeglRectangle   roi;
-    gint            stride;
+    cairo_rectangle_int_t done;
+    /* The node only reports what was computed at full resolution */
+    gboolean redraw = self->current_level > 0;
+    gint level;
 
-    roi.x = self->x + rect->x;
-    roi.y = self->y + rect->y;
-    roi.width  = rect->width;
-    roi.height = rect->height;
-
-    stride = cairo_format_stride_for_width(CAIRO_FORMAT_ARGB32, roi.width);
-    buf = g_malloc(stride * roi.height);
+    to_cairo_rectangle(self->currently_processed_rect, &done);
+    g_free(self->currently_processed_rect);
+    self->currently_processed_rect = NULL;
 
-    gegl_node_blit(self->node,
-                   self->scale,
-                   &roi,
-                   babl_format("cairo-ARGB32"),
-                   (gpointer)buf,
-                   GEGL_AUTO_ROWSTRIDE,
-                   GEGL_BLIT_CACHE | (self->block ? 0 : GEGL_BLIT_DIRTY));
-
-    surface = cairo_image_surface_create_for_data(buf,
-              CAIRO_FORMAT_ARGB32,
-              roi.width, roi.height,
-              stride);
-    cairo_set_source_surface(cr, surface, rect->x, rect->y);
-    cairo_paint(cr);
+    if (self->current_coarse) {
+        cairo_region_union_rectangle(self->coarse_region, &done);
+    } else {
+        if (cairo_region_contains_rectangle(self->coarse_region, &done)
+                != CAIRO_REGION_OVERLAP_OUT) {
+            /* Tiles drawn from the coarse results may have been cached
+             * after the last "computed" of this rect was handled */
+            cairo_region_subtract_rectangle(self->coarse_region, &done);
+            redraw = TRUE;
+        }
 
-    cairo_surface_destroy(surface);
-    g_free(buf);
+        for (level = 1; level <= VIEW_HELPER_MAX_LEVEL; level++) {
+            if (level == self->current_level)
+                cairo_region_union_rectangle(self->lod_region[level], &done);
+            else
+                cairo_region_subtract_rectangle(self->lod_region[level], &done);
+        }
+    }
 
+    if (redraw) {
+        cairo_region_union_rectangle(self->computed_region, &done);
+        schedule_results(self);
+    }
 }
 
-void
-view_helper_set_allocation(ViewHelper *self, GdkRectangle *allocation)
+/* gegl_processor_work() on @rect, keeping statistics.
+ * Called from the main thread, or from the worker with process_mutex held */
+static gboolean
+work_processor(ViewHelper *self, const GeglRectangle *rect)
 {
-    self->widget_allocation = *allocation;
-    update_autoscale(self);
+    gint64 trace_start = trace_begin();
+    gint64 start = g_get_monotonic_time();
+    gdouble progress = 0.0;
+    gboolean more_work;
+
+    more_work = gegl_processor_work(self->processor, &progress);
+
+    g_mutex_lock(&self->stats_mutex);
+    self->stats_process_time += g_get_monotonic_time() - start;
+    self->progress = progress;
+    g_mutex_unlock(&self->stats_mutex);
+
+    if (trace_start)
+        trace_span("process", trace_start, rect);
+
+    return more_work;
 }
 
-/* Trigger processing of the GeglNode */
-void
-trigger_processing(ViewHelper *self, GeglRectangle roi)
+/* Queue the areas which were processed at a lower level of detail than
+ * the view now shows, after zooming in */
+static void
+refine_lod(ViewHelper *self)
 {
-    //GeglRectangle    roi;
+    gint level, i;
 
-    // PERFORMANCE: determine the area that the view widget is interested in,
-    // and calculate the intersection with the invalidated rect
-    // and only pass this value as the ROI
-    // Would then also have to follow changes in view transformation
-
-    if (!self->node)
-        return;
+    for (level = self->view_level + 1; level <= VIEW_HELPER_MAX_LEVEL; level++) {
+        cairo_region_t *region;
 
-//    roi.x = self->x / self->scale;
-//    roi.y = self->y / self->scale;
+        g_mutex_lock(&self->queue_mutex);
+        region = self->lod_region[level];
+        self->lod_region[level] = cairo_region_create();
+        g_mutex_unlock(&self->queue_mutex);
 
-//    roi.width = ceil(self->widget_allocation.width / self->scale + 1);
-//    roi.height = ceil(self->widget_allocation.height / self->scale + 1);
+        for (i = 0; i < cairo_region_num_rectangles(region); i++) {
+            cairo_rectangle_int_t r;
+            GeglRectangle roi;
 
-    if (self->monitor_id == 0) {
-        self->monitor_id = g_idle_add_full(G_PRIORITY_LOW,
-                                           (GSourceFunc) task_monitor, self,
-                                           NULL);
+            cairo_region_get_rectangle(region, i, &r);
+            gegl_rectangle_set(&roi, r.x, r.y, r.width, r.height);
+            trigger_processing(self, roi);
+        }
+        cairo_region_destroy(region);
     }
-
-    // Add the invalidated region to the dirty
-    GeglRectangle *rect = g_new(GeglRectangle, 1);
-    rect->x = roi.x;
-    rect->y = roi.y;
-    rect->width = roi.width;
-    rect->height = roi.height;
-    g_queue_push_head(self->processing_queue, rect);
 }
 
-void
-trigger_redraw(ViewHelper *self, GeglRectangle *redraw_rect)
+/* Process the dirty region in chunks.
+ * Keeps calling gegl_processor_work() until the processing budget for
+ * this main loop iteration is used up, so that fast machines are kept busy
+ * while slow ones still get back to the main loop in time for input. */
+static gboolean
+task_monitor(ViewHelper *self)
 {
-  GeglRectangle invalid_rect = {0, 0, -1, -1}; /* Indicates full redraw */
+    gint64 start_time;
 
-    if (!redraw_rect) {
-        redraw_rect = &invalid_rect;
+    if (!self->processor || !self->node) {
+        self->monitor_id = 0;
+        return FALSE;
     }
 
-    g_signal_emit(self, view_helper_signals[SIGNAL_REDRAW_NEEDED],
-                  0, redraw_rect, NULL);
+    start_time = g_get_monotonic_time();
+
+    do {
+        // Invalidations arriving between two iterations are merged into
+        // processing_region, so each dirty pixel is only scheduled once
+
+        if (!self->currently_processed_rect) {
+            if (!take_next_rect(self)) {
+                // Unregister worker
+                self->monitor_id = 0;
+                return FALSE;
+            }
+            gegl_processor_set_level(self->processor, self->current_level);
+            gegl_processor_set_rectangle(self->processor, self->currently_processed_rect);
+        }
+
+        if (!work_processor(self, self->currently_processed_rect)) {
+            // Go to next region
+            finish_rect(self);
+        }
+
+        /* Leave the main loop to drawing while interacting */
+    } while (!self->interactive &&
+             g_get_monotonic_time() - start_time < self->processing_budget);
+
+    return TRUE;
 }
 
-void
-view_helper_set_node(ViewHelper *self, GeglNode *node)
+/* Drop all queued work, and the rect being processed.
+ * Used when the node changes, as the work was for the previous node */
+static void
+cancel_processing(ViewHelper *self)
 {
-    if (self->node == node)
-        return;
-
-    if (self->node) {
-        g_signal_handler_disconnect (self->node, self->computed_id);
-        g_signal_handler_disconnect (self->node, self->invalidated_id);
-        g_object_unref(self->node);
+    gint i;
+
+    g_mutex_lock(&self->queue_mutex);
+    cairo_region_destroy(self->processing_region);
+    self->processing_region = cairo_region_create();
+    cairo_region_destroy(self->computed_region);
+    self->computed_region = cairo_region_create();
+    cairo_region_destroy(self->coarse_queue);
+    self->coarse_queue = cairo_region_create();
+    cairo_region_destroy(self->coarse_region);
+    self->coarse_region = cairo_region_create();
+    for (i = 0; i <= VIEW_HELPER_MAX_LEVEL; i++) {
+        cairo_region_destroy(self->lod_region[i]);
+        self->lod_region[i] = cairo_region_create();
     }
+    g_free(self->currently_processed_rect);
+    self->currently_processed_rect = NULL;
+    g_mutex_unlock(&self->queue_mutex);
 
-    if (node) {
-        g_object_ref(node);
-        self->node = node;
+    cairo_region_destroy(self->deferred_region);
+    self->deferred_region = cairo_region_create();
+}
 
-        self->computed_id = g_signal_connect_object(self->node, "computed",
-                                                    G_CALLBACK(computed_event),
-                                                    self, 0);
-        self->invalidated_id = g_signal_connect_object(self->node, "invalidated",
-                                                       G_CALLBACK(invalidated_event),
-                                                       self, 0);
+/* Move queued work outside of @visible back to the deferred region,
+ * or all of it if @visible is NULL.
+ * It will be processed when it comes into view again, see process_deferred() */
+static void
+defer_queued(ViewHelper *self, const GeglRectangle *visible)
+{
+    cairo_rectangle_int_t visible_area = {0, 0, 0, 0};
+    cairo_region_t *invisible;
 
-        if (self->processor)
-            g_object_unref(self->processor);
+    if (visible)
+        to_cairo_rectangle(visible, &visible_area);
 
-        GeglRectangle bbox = gegl_node_get_bounding_box(self->node);
-        self->processor = gegl_node_new_processor(self->node, &bbox);
+    g_mutex_lock(&self->queue_mutex);
 
-        update_autoscale(self);
-        trigger_processing(self, bbox);
+    invisible = cairo_region_copy(self->processing_region);
+    cairo_region_subtract_rectangle(invisible, &visible_area);
+    cairo_region_intersect_rectangle(self->processing_region, &visible_area);
+    /* The coarse pass is queued again along with the deferred area */
+    cairo_region_intersect_rectangle(self->coarse_queue, &visible_area);
 
-    } else {
-        self->node = NULL;
-        self->computed_id = 0;
-        self->invalidated_id = 0;
+    if (self->currently_processed_rect &&
+            (!visible || !gegl_rectangle_intersect(NULL, self->currently_processed_rect, visible))) {
+        cairo_rectangle_int_t current;
+
+        /* A coarse rect is still in processing_region at full resolution */
+        if (!self->current_coarse) {
+            to_cairo_rectangle(self->currently_processed_rect, &current);
+            cairo_region_union_rectangle(invisible, &current);
+        }
+        g_free(self->currently_processed_rect);
+        self->currently_processed_rect = NULL;
     }
-}
 
-GeglNode *
-view_helper_get_node(ViewHelper *self)
-{
-    return self->node;
+    g_mutex_unlock(&self->queue_mutex);
+
+    cairo_region_union(self->deferred_region, invisible);
+    cairo_region_destroy(invisible);
 }
 
-void
-view_helper_set_scale(ViewHelper *self, float scale)
+/* Move queued work which is no longer visible back to the deferred region */
+static void
+prune_invisible(ViewHelper *self)
 {
-    if (self->scale == scale)
+    GeglRectangle visible;
+
+    if (!get_visible_model_rect(self, &visible))
         return;
 
-    self->scale = scale;
-    update_autoscale(self);
-    trigger_redraw(self, NULL);
+    defer_queued(self, &visible);
 }
 
-float
-view_helper_get_scale(ViewHelper *self)
+/* Make sure the processing idle source is running */
+static void
+start_monitor(ViewHelper *self)
 {
-    return self->scale;
+    if (self->monitor_id == 0) {
+        self->monitor_id = g_idle_add_full(self->processing_priority,
+                                           (GSourceFunc) task_monitor, self,
+                                           NULL);
+    }
+}
+
+
+/* When the GeglNode has been computed,
+ * find out if the size of the vie changed and
+ * emit the "size-changed" signal to notify view
+ * find out which area in the view was computed and emit the
+ * "redraw-needed" signal to notify it that a redraw is needed */
+static void
+handle_computed(ViewHelper *self, GeglRectangle *rect)
+{
+    update_autoscale(self);
+
+    /* Cached tiles covering the area are now out of date */
+    tile_cache_invalidate(self->tile_cache, rect);
+
+    /* Emit redraw-needed */
+    GeglRectangle redraw_rect = *rect;
+    model_rect_to_view_rect(self, &redraw_rect);
+
+    trigger_redraw(self, &redraw_rect);
+}
+
+/* Hand what the worker thread computed over to the main thread */
+static gboolean
+dispatch_results(ViewHelper *self)
+{
+    cairo_region_t *computed;
+    gint i;
+
+    g_mutex_lock(&self->queue_mutex);
+    computed = self->computed_region;
+    self->computed_region = cairo_region_create();
+    self->results_id = 0;
+    g_mutex_unlock(&self->queue_mutex);
+
+    for (i = 0; i < cairo_region_num_rectangles(computed); i++) {
+        cairo_rectangle_int_t r;
+        GeglRectangle rect;
+
+        cairo_region_get_rectangle(computed, i, &r);
+        gegl_rectangle_set(&rect, r.x, r.y, r.width, r.height);
+        handle_computed(self, &rect);
+    }
+    cairo_region_destroy(computed);
+
+    return FALSE;
+}
+
+/* Must be called with queue_mutex held */
+static void
+schedule_results(ViewHelper *self)
+{
+    if (self->results_id == 0) {
+        self->results_id = g_idle_add_full(G_PRIORITY_DEFAULT_IDLE,
+                                           (GSourceFunc) dispatch_results, self,
+                                           NULL);
+    }
+}
+
+static void
+computed_event(GeglNode      *node,
+               GeglRectangle *rect,
+               ViewHelper    *self)
+{
+    trace_instant("computed", rect);
+
+    if (g_thread_self() != self->main_thread) {
+        /* Computed outside of the main thread, pass it on */
+        cairo_rectangle_int_t area;
+
+        to_cairo_rectangle(rect, &area);
+        g_mutex_lock(&self->queue_mutex);
+        cairo_region_union_rectangle(self->computed_region, &area);
+        schedule_results(self);
+        g_mutex_unlock(&self->queue_mutex);
+        return;
+    }
+
+    handle_computed(self, rect);
+}
+
+/* Drives the GeglProcessor outside of the main thread, in threaded mode.
+ * The results are handed back to the main thread by dispatch_results() */
+static gpointer
+worker_thread(gpointer data)
+{
+    ViewHelper *self = VIEW_HELPER(data);
+    gboolean new_rect;
+    guint generation;
+    gint level;
+
+    g_mutex_lock(&self->queue_mutex);
+    while (!self->worker_quit) {
+        GeglRectangle rect;
+        gboolean more_work = FALSE;
+
+        new_rect = FALSE;
+        if (!self->currently_processed_rect) {
+            if (!take_next_rect(self)) {
+                g_cond_wait(&self->queue_cond, &self->queue_mutex);
+                continue;
+            }
+            new_rect = TRUE;
+        }
+        rect = *self->currently_processed_rect;
+        level = self->current_level;
+        generation = self->generation;
+        g_mutex_unlock(&self->queue_mutex);
+
+        g_rec_mutex_lock(&self->process_mutex);
+        /* Skip the job if the node was changed in the meantime */
+        if (self->processor && generation == self->generation) {
+            if (new_rect) {
+                gegl_processor_set_level(self->processor, level);
+                gegl_processor_set_rectangle(self->processor, &rect);
+            }
+            more_work = work_processor(self, &rect);
+        }
+        g_rec_mutex_unlock(&self->process_mutex);
+
+        g_mutex_lock(&self->queue_mutex);
+        if (!more_work && self->currently_processed_rect)
+            finish_rect(self);
+        schedule_results(self);
+    }
+    g_mutex_unlock(&self->queue_mutex);
+
+    return NULL;
+}
+
+ViewHelper *
+view_helper_new(void)
+{
+    return VIEW_HELPER(g_object_new(VIEW_HELPER_TYPE, NULL));
+}
+
+/* A tile needed for drawing */
+typedef struct {
+    ViewHelper      *self;
+    gint             tile_x;
+    gint             tile_y;
+    cairo_surface_t *surface;
+    gboolean         needs_render;
+    gboolean         coarse; /* Only coarse results are available */
+    gboolean         placeholder; /* Drawn from tiles at drawn_scale */
+} DrawTile;
+
+/* Whether blits process the node where it is dirty. Only when blocking,
+ * and not while interactive. Otherwise they take what is in the cache of
+ * the node, and leave the dirty parts to the processing queue */
+static gboolean
+blits_process(ViewHelper *self)
+{
+    return self->block && !self->interactive;
+}
+
+static GeglBlitFlags
+get_blit_flags(ViewHelper *self)
+{
+    return GEGL_BLIT_CACHE | (blits_process(self) ? 0 : GEGL_BLIT_DIRTY);
+}
+
+/* gegl_node_blit() into @surface, keeping statistics.
+ * Called from the render threads */
+static void
+blit_node(ViewHelper *self, gdouble scale, const GeglRectangle *roi,
+          cairo_surface_t *surface, GeglBlitFlags flags)
+{
+    gint64 trace_start = trace_begin();
+    gint64 start = g_get_monotonic_time();
+
+    cairo_surface_flush(surface);
+    gegl_node_blit(self->node,
+                   scale,
+                   roi,
+                   babl_format("cairo-ARGB32"),
+                   (gpointer)cairo_image_surface_get_data(surface),
+                   cairo_image_surface_get_stride(surface),
+                   flags);
+    cairo_surface_mark_dirty(surface);
+
+    g_mutex_lock(&self->stats_mutex);
+    self->stats_blit_time += g_get_monotonic_time() - start;
+    self->stats_pixels_blitted += (guint64)roi->width * roi->height;
+    g_mutex_unlock(&self->stats_mutex);
+
+    if (trace_start)
+        trace_span("blit", trace_start, roi);
+}
+
+/* Take a scratch surface of @width x @height from the pool.
+ * Pooled surfaces can be larger than asked for, so the result is a view
+ * of exactly the requested size onto the pixels of *@pooled, which goes
+ * back to the pool with release_scratch() */
+static cairo_surface_t *
+acquire_scratch(ViewHelper *self, gint width, gint height, cairo_surface_t **pooled)
+{
+    *pooled = surface_pool_acquire(self->surface_pool, width, height);
+    cairo_surface_flush(*pooled);
+
+    return cairo_image_surface_create_for_data(cairo_image_surface_get_data(*pooled),
+                                               CAIRO_FORMAT_ARGB32, width, height,
+                                               cairo_image_surface_get_stride(*pooled));
+}
+
+static void
+release_scratch(ViewHelper *self, cairo_surface_t *scratch, cairo_surface_t *pooled)
+{
+    cairo_surface_destroy(scratch);
+    surface_pool_release(self->surface_pool, pooled);
+}
+
+/* Render a tile when zoomed in, by fetching the model pixels under it
+ * at their native resolution and magnifying them with cairo.
+ * Blitting at the view scale would resample every view pixel through
+ * the graph instead, which is scale² times the work. */
+static void
+render_magnified_tile(ViewHelper *self, gint tile_x, gint tile_y, cairo_surface_t *surface)
+{
+    const gdouble size = TILE_CACHE_TILE_SIZE / self->scale;
+    cairo_surface_t *model, *pooled;
+    GeglRectangle    roi;
+    cairo_t         *cr;
+    gint             x1, y1, x2, y2;
+
+    /* With a margin, for interpolating at the edges */
+    x1 = clamp_to_int(floor(tile_x * size) - 1);
+    y1 = clamp_to_int(floor(tile_y * size) - 1);
+    x2 = clamp_to_int(ceil((tile_x + 1) * size) + 1);
+    y2 = clamp_to_int(ceil((tile_y + 1) * size) + 1);
+    gegl_rectangle_set(&roi, x1, y1, x2 - x1, y2 - y1);
+
+    model = acquire_scratch(self, roi.width, roi.height, &pooled);
+    blit_node(self, 1.0, &roi, model,
+              get_blit_flags(self));
+
+    cr = cairo_create(surface);
+    cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+    cairo_scale(cr, self->scale, self->scale);
+    cairo_set_source_surface(cr, model, x1 - tile_x * size, y1 - tile_y * size);
+    cairo_pattern_set_filter(cairo_get_source(cr),
+                             self->filter == GEGL_GTK_VIEW_FILTER_BILINEAR &&
+                             !self->interactive ?
+                             CAIRO_FILTER_BILINEAR : CAIRO_FILTER_NEAREST);
+    cairo_paint(cr);
+    cairo_destroy(cr);
+
+    release_scratch(self, model, pooled);
+}
+
+/* Render a single tile of the view at the current scale.
+ * @tile_x, @tile_y are tile indices in scaled model coordinates
+ *
+ * Only touches @surface, so tiles can be rendered concurrently */
+static void
+render_tile(ViewHelper *self, gint tile_x, gint tile_y, cairo_surface_t *surface)
+{
+    GeglRectangle    roi;
+
+    if (self->scale > 1.0) {
+        render_magnified_tile(self, tile_x, tile_y, surface);
+        return;
+    }
+
+    roi.x = tile_x * TILE_CACHE_TILE_SIZE;
+    roi.y = tile_y * TILE_CACHE_TILE_SIZE;
+    roi.width  = TILE_CACHE_TILE_SIZE;
+    roi.height = TILE_CACHE_TILE_SIZE;
+
+    blit_node(self, self->scale, &roi, surface,
+              get_blit_flags(self));
+}
+
+/* Render a tile at 1/@factor of the view resolution, by blitting at a
+ * fraction of the scale and magnifying the result.
+ * Used for the coarse results of progressive rendering, and while interactive */
+static void
+render_reduced_tile(ViewHelper *self, gint tile_x, gint tile_y, cairo_surface_t *surface,
+                    gint factor)
+{
+    const gint size = TILE_CACHE_TILE_SIZE / factor;
+    cairo_surface_t *coarse, *pooled;
+    GeglRectangle    roi;
+    cairo_t         *cr;
+
+    gegl_rectangle_set(&roi, tile_x * size, tile_y * size, size, size);
+
+    coarse = acquire_scratch(self, size, size, &pooled);
+    blit_node(self, self->scale / factor, &roi, coarse, GEGL_BLIT_CACHE | GEGL_BLIT_DIRTY);
+
+    cr = cairo_create(surface);
+    cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+    cairo_scale(cr, factor, factor);
+    cairo_set_source_surface(cr, coarse, 0, 0);
+    cairo_pattern_set_filter(cairo_get_source(cr), CAIRO_FILTER_BILINEAR);
+    cairo_pattern_set_extend(cairo_get_source(cr), CAIRO_EXTEND_PAD);
+    cairo_paint(cr);
+    cairo_destroy(cr);
+
+    release_scratch(self, coarse, pooled);
+}
+
+static void
+render_draw_tile(DrawTile *tile)
+{
+    ViewHelper *self = tile->self;
+
+    if (tile->coarse) {
+        render_reduced_tile(self, tile->tile_x, tile->tile_y, tile->surface,
+                            PROGRESSIVE_FACTOR);
+    } else if (self->interactive && self->scale <= 1.0) {
+        /* Magnified tiles are already cheap, they only use a cheaper filter */
+        render_reduced_tile(self, tile->tile_x, tile->tile_y, tile->surface,
+                            INTERACTIVE_FACTOR);
+    } else {
+        render_tile(self, tile->tile_x, tile->tile_y, tile->surface);
+    }
+}
+
+/* Add a freshly rendered tile to the cache.
+ * Tiles rendered while interactive are remembered, to be replaced by
+ * full quality ones when the interaction ends */
+static void
+insert_tile(ViewHelper *self, DrawTile *tile)
+{
+    tile_cache_insert(self->tile_cache, self->scale,
+                      tile->tile_x, tile->tile_y, tile->surface);
+
+    if (self->interactive) {
+        InteractiveTile key = { self->scale, tile->tile_x, tile->tile_y };
+        g_array_append_val(self->interactive_tiles, key);
+    }
+}
+
+/* Tiles being rendered by render_tiles(). The calling thread and the
+ * pool threads take the next tile from @next until none are left */
+typedef struct {
+    GArray *tiles;
+    gint    next;
+} RenderBatch;
+
+static void
+render_batch_run(RenderBatch *batch)
+{
+    gint i;
+
+    while ((i = g_atomic_int_add(&batch->next, 1)) < (gint)batch->tiles->len) {
+        DrawTile *tile = &g_array_index(batch->tiles, DrawTile, i);
+
+        if (tile->needs_render)
+            render_draw_tile(tile);
+    }
+}
+
+static void
+render_tile_func(gpointer data, gpointer user_data)
+{
+    RenderBatch *batch = data;
+    ViewHelper *self = user_data;
+
+    render_batch_run(batch);
+
+    g_mutex_lock(&self->render_mutex);
+    if (--self->render_pending == 0)
+        g_cond_signal(&self->render_cond);
+    g_mutex_unlock(&self->render_mutex);
+}
+
+/* Number of threads to render tiles with */
+static gint
+get_render_threads(ViewHelper *self)
+{
+    gint threads = self->render_threads;
+
+    if (threads <= 0)
+        g_object_get(gegl_config(), "threads", &threads, NULL);
+
+    return MAX(threads, 1);
+}
+
+/* Render the tiles which need it, spread over the render thread pool.
+ * The calling thread keeps rendering tiles too, until all are taken.
+ *
+ * Blocking renders process the graph, which is not safe to do from
+ * several threads at once, so those are done serially. */
+static void
+render_tiles(ViewHelper *self, GArray *tiles)
+{
+    gint threads = get_render_threads(self);
+    RenderBatch batch = { tiles, 0 };
+    gint to_render = 0;
+    gint helpers, i;
+
+    for (i = 0; i < (gint)tiles->len; i++) {
+        if (g_array_index(tiles, DrawTile, i).needs_render)
+            to_render++;
+    }
+
+    helpers = (self->block || to_render < 2) ? 0 : MIN(threads - 1, to_render - 1);
+
+    if (helpers > 0) {
+        if (!self->render_pool) {
+            self->render_pool = g_thread_pool_new(render_tile_func, self,
+                                                  threads - 1, FALSE, NULL);
+        } else {
+            g_thread_pool_set_max_threads(self->render_pool, threads - 1, NULL);
+        }
+
+        g_mutex_lock(&self->render_mutex);
+        self->render_pending += helpers;
+        g_mutex_unlock(&self->render_mutex);
+
+        for (i = 0; i < helpers; i++)
+            g_thread_pool_push(self->render_pool, &batch, NULL);
+    }
+
+    render_batch_run(&batch);
+
+    g_mutex_lock(&self->render_mutex);
+    while (self->render_pending > 0)
+        g_cond_wait(&self->render_cond, &self->render_mutex);
+    g_mutex_unlock(&self->render_mutex);
+}
+
+/* Whether the model area under a tile has only been processed coarsely.
+ * Must be called with queue_mutex held */
+static gboolean
+is_coarse_tile(ViewHelper *self, gint tile_x, gint tile_y)
+{
+    cairo_rectangle_int_t model;
+    gdouble x1, y1, x2, y2;
+
+    if (cairo_region_is_empty(self->coarse_region))
+        return FALSE;
+
+    x1 = floor(tile_x * TILE_CACHE_TILE_SIZE / self->scale);
+    y1 = floor(tile_y * TILE_CACHE_TILE_SIZE / self->scale);
+    x2 = ceil((tile_x + 1) * TILE_CACHE_TILE_SIZE / self->scale);
+    y2 = ceil((tile_y + 1) * TILE_CACHE_TILE_SIZE / self->scale);
+
+    model.x = clamp_to_int(x1);
+    model.y = clamp_to_int(y1);
+    model.width = clamp_to_int(x2 - x1);
+    model.height = clamp_to_int(y2 - y1);
+
+    return cairo_region_contains_rectangle(self->coarse_region, &model)
+           != CAIRO_REGION_OVERLAP_OUT;
+}
+
+/* Get exclusive access to the node, for blitting, if the blits process it.
+ * That waits for the worker thread to finish its current chunk.
+ * Blits which only read the cache of the node need no lock: GEGL buffers
+ * can be read while the worker writes to them, and the graph itself only
+ * changes on the main thread.
+ * Returns whether the lock was taken */
+static gboolean
+lock_processing(ViewHelper *self)
+{
+    if (!blits_process(self))
+        return FALSE;
+
+    g_rec_mutex_lock(&self->process_mutex);
+    return TRUE;
+}
+
+/* Get the range of tiles at drawn_scale that cover a tile
+ * at the current scale */
+static void
+get_placeholder_range(ViewHelper *self, gint tile_x, gint tile_y,
+                      gint *first_x, gint *first_y, gint *last_x, gint *last_y)
+{
+    const gdouble ratio = self->drawn_scale / self->scale;
+    const gint size = TILE_CACHE_TILE_SIZE;
+
+    *first_x = floor_div(clamp_to_int(floor(tile_x * size * ratio)), size);
+    *first_y = floor_div(clamp_to_int(floor(tile_y * size * ratio)), size);
+    *last_x = floor_div(clamp_to_int(ceil((tile_x + 1) * size * ratio) - 1), size);
+    *last_y = floor_div(clamp_to_int(ceil((tile_y + 1) * size * ratio) - 1), size);
+}
+
+/* Whether a missing tile can be drawn from the tiles of the last scale
+ * the view was fully drawn at. Only if they cover all of it, as a partial
+ * placeholder would leave holes on screen until the tile is rendered */
+static gboolean
+has_placeholder(ViewHelper *self, gint tile_x, gint tile_y)
+{
+    gint first_x, first_y, last_x, last_y, x, y;
+
+    if (self->drawn_scale <= 0.0 || self->drawn_scale == self->scale)
+        return FALSE;
+
+    get_placeholder_range(self, tile_x, tile_y, &first_x, &first_y, &last_x, &last_y);
+
+    for (y = first_y; y <= last_y; y++) {
+        for (x = first_x; x <= last_x; x++) {
+            if (!tile_cache_lookup(self->tile_cache, self->drawn_scale, x, y))
+                return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/* Draw @area of a tile, in scaled model coordinates, by scaling up or
+ * down the tiles which were rendered at drawn_scale */
+static void
+draw_placeholder(ViewHelper *self, cairo_t *cr, gint tile_x, gint tile_y,
+                 cairo_region_t *area)
+{
+    const gdouble ratio = self->scale / self->drawn_scale;
+    const gint size = TILE_CACHE_TILE_SIZE;
+    gint origin_x = self->x;
+    gint origin_y = self->y;
+    gint first_x, first_y, last_x, last_y, x, y, i;
+
+    get_placeholder_range(self, tile_x, tile_y, &first_x, &first_y, &last_x, &last_y);
+
+    cairo_save(cr);
+
+    for (i = 0; i < cairo_region_num_rectangles(area); i++) {
+        cairo_rectangle_int_t r;
+
+        cairo_region_get_rectangle(area, i, &r);
+        cairo_rectangle(cr, r.x - origin_x, r.y - origin_y, r.width, r.height);
+    }
+    cairo_clip(cr);
+
+    cairo_translate(cr, -origin_x, -origin_y);
+    cairo_scale(cr, ratio, ratio);
+
+    for (y = first_y; y <= last_y; y++) {
+        for (x = first_x; x <= last_x; x++) {
+            cairo_surface_t *surface =
+                tile_cache_lookup(self->tile_cache, self->drawn_scale, x, y);
+
+            if (!surface)
+                continue;
+
+            cairo_set_source_surface(cr, surface, x * size, y * size);
+            /* Avoid seams between the magnified tiles */
+            cairo_pattern_set_extend(cairo_get_source(cr), CAIRO_EXTEND_PAD);
+            cairo_rectangle(cr, x * size, y * size, size, size);
+            cairo_fill(cr);
+        }
+    }
+
+    cairo_restore(cr);
+}
+
+/* Render tiles that were drawn from placeholders, a batch at a time,
+ * until the processing budget for this iteration is used up */
+static gboolean
+render_pending(ViewHelper *self)
+{
+    gint64 start_time = g_get_monotonic_time();
+    gint batch_size = get_render_threads(self);
+
+    while (!cairo_region_is_empty(self->pending_region)) {
+        GArray *tiles;
+        cairo_rectangle_int_t r;
+        gint origin_x = self->x;
+        gint origin_y = self->y;
+        gint tile_x, tile_y;
+        gboolean locked;
+        guint i;
+
+        if (!self->node)
+            break;
+
+        locked = lock_processing(self);
+
+        /* Pick the tiles along the first pending rectangle */
+        tiles = g_array_new(FALSE, FALSE, sizeof(DrawTile));
+        g_mutex_lock(&self->queue_mutex);
+        cairo_region_get_rectangle(self->pending_region, 0, &r);
+        tile_y = floor_div(r.y, TILE_CACHE_TILE_SIZE);
+        for (tile_x = floor_div(r.x, TILE_CACHE_TILE_SIZE);
+                tile_x * TILE_CACHE_TILE_SIZE < r.x + r.width &&
+                (gint)tiles->len < batch_size;
+                tile_x++) {
+            DrawTile tile = { self, tile_x, tile_y, NULL, TRUE, FALSE, FALSE };
+
+            if (tile_cache_lookup(self->tile_cache, self->scale, tile_x, tile_y)) {
+                tile.needs_render = FALSE;
+            } else {
+                tile.surface = surface_pool_acquire(self->surface_pool,
+                                                    TILE_CACHE_TILE_SIZE,
+                                                    TILE_CACHE_TILE_SIZE);
+                tile.coarse = !self->block && is_coarse_tile(self, tile_x, tile_y);
+            }
+            g_array_append_val(tiles, tile);
+        }
+        g_mutex_unlock(&self->queue_mutex);
+
+        render_tiles(self, tiles);
+        if (locked)
+            g_rec_mutex_unlock(&self->process_mutex);
+
+        for (i = 0; i < tiles->len; i++) {
+            DrawTile *tile = &g_array_index(tiles, DrawTile, i);
+            cairo_rectangle_int_t tile_rect = {
+                tile->tile_x * TILE_CACHE_TILE_SIZE, tile->tile_y * TILE_CACHE_TILE_SIZE,
+                TILE_CACHE_TILE_SIZE, TILE_CACHE_TILE_SIZE
+            };
+            GeglRectangle redraw_rect;
+
+            if (tile->needs_render) {
+                insert_tile(self, tile);
+                cairo_surface_destroy(tile->surface);
+            }
+            cairo_region_subtract_rectangle(self->pending_region, &tile_rect);
+
+            gegl_rectangle_set(&redraw_rect, tile_rect.x - origin_x, tile_rect.y - origin_y,
+                               tile_rect.width, tile_rect.height);
+            trigger_redraw(self, &redraw_rect);
+        }
+        g_array_free(tiles, TRUE);
+
+        if (g_get_monotonic_time() - start_time >= self->processing_budget)
+            return TRUE;
+    }
+
+    /* Caught up with the zoom, the view is now fully drawn at this scale */
+    cairo_region_destroy(self->pending_region);
+    self->pending_region = cairo_region_create();
+    self->drawn_scale = self->scale;
+    self->pending_id = 0;
+    return FALSE;
+}
+
+/* Start rendering the pending tiles in the background, unless suspended.
+ * view_helper_set_suspended() starts it again on resume */
+static void
+start_pending(ViewHelper *self)
+{
+    if (self->suspended)
+        return;
+
+    if (self->pending_id == 0) {
+        self->pending_id = g_idle_add_full(G_PRIORITY_DEFAULT_IDLE,
+                                           (GSourceFunc) render_pending, self,
+                                           NULL);
+    }
+}
+
+/* Draw the view of the GeglNode to the provided cairo context,
+ * taking into account transformations et.c.
+ * @region the area to draw in view coordinates
+ *
+ * The view is drawn from a cache of rendered tiles. Only tiles that
+ * are missing from the cache are blitted from the GeglNode,
+ * concurrently on the render thread pool. Tiles in the bounding box
+ * of @region that do not touch any of its rectangles are skipped.
+ *
+ * Right after a zoom, missing tiles are drawn scaled from the tiles of
+ * the previous scale instead, and rendered afterwards in an idle.
+ *
+ * For instance called by widget during the draw/expose */
+void
+view_helper_draw_region(ViewHelper *self, cairo_t *cr, const cairo_region_t *region)
+{
+    cairo_rectangle_int_t extents;
+    cairo_region_t *model_region;
+    GArray         *tiles;
+    gint            origin_x, origin_y;
+    gint            first_x, first_y, last_x, last_y;
+    gint            tile_x, tile_y;
+    gboolean        needs_render = FALSE;
+    gboolean        locked = FALSE;
+    gboolean        complete = TRUE; /* Every tile drawn at the current scale */
+    gint64          trace_start;
+    guint           i;
+
+    if (!self->node || cairo_region_is_empty(region))
+        return;
+
+    trace_start = trace_begin();
+
+    g_mutex_lock(&self->stats_mutex);
+    self->stats_exposes++;
+    g_mutex_unlock(&self->stats_mutex);
+
+    origin_x = self->x;
+    origin_y = self->y;
+
+    /* Work in scaled model coordinates, where the tiles are */
+    model_region = cairo_region_copy(region);
+    cairo_region_translate(model_region, origin_x, origin_y);
+    cairo_region_get_extents(model_region, &extents);
+
+    first_x = floor_div(extents.x, TILE_CACHE_TILE_SIZE);
+    first_y = floor_div(extents.y, TILE_CACHE_TILE_SIZE);
+    last_x = floor_div(extents.x + extents.width - 1, TILE_CACHE_TILE_SIZE);
+    last_y = floor_div(extents.y + extents.height - 1, TILE_CACHE_TILE_SIZE);
+
+    tiles = g_array_sized_new(FALSE, FALSE, sizeof(DrawTile),
+                              (last_x - first_x + 1) * (last_y - first_y + 1));
+
+    /* Find the tiles to draw, and which of them have to be rendered */
+    g_mutex_lock(&self->queue_mutex);
+    for (tile_y = first_y; tile_y <= last_y; tile_y++) {
+        for (tile_x = first_x; tile_x <= last_x; tile_x++) {
+            DrawTile tile = { self, tile_x, tile_y, NULL, FALSE, FALSE, FALSE };
+            cairo_rectangle_int_t tile_rect = {
+                tile_x * TILE_CACHE_TILE_SIZE, tile_y * TILE_CACHE_TILE_SIZE,
+                TILE_CACHE_TILE_SIZE, TILE_CACHE_TILE_SIZE
+            };
+
+            if (cairo_region_contains_rectangle(model_region, &tile_rect) ==
+                    CAIRO_REGION_OVERLAP_OUT)
+                continue;
+
+            tile.surface = tile_cache_lookup(self->tile_cache, self->scale, tile_x, tile_y);
+            if (tile.surface) {
+                cairo_surface_reference(tile.surface);
+            } else if (has_placeholder(self, tile_x, tile_y)) {
+                tile.placeholder = TRUE;
+            } else {
+                tile.surface = surface_pool_acquire(self->surface_pool,
+                                                    TILE_CACHE_TILE_SIZE,
+                                                    TILE_CACHE_TILE_SIZE);
+                tile.needs_render = TRUE;
+                tile.coarse = !self->block && is_coarse_tile(self, tile_x, tile_y);
+                needs_render = TRUE;
+            }
+            g_array_append_val(tiles, tile);
+        }
+    }
+    g_mutex_unlock(&self->queue_mutex);
+
+    if (needs_render) {
+        locked = lock_processing(self);
+        render_tiles(self, tiles);
+        if (locked)
+            g_rec_mutex_unlock(&self->process_mutex);
+    }
+
+    for (i = 0; i < tiles->len; i++) {
+        DrawTile *tile = &g_array_index(tiles, DrawTile, i);
+        cairo_rectangle_int_t tile_rect = {
+            tile->tile_x * TILE_CACHE_TILE_SIZE, tile->tile_y * TILE_CACHE_TILE_SIZE,
+            TILE_CACHE_TILE_SIZE, TILE_CACHE_TILE_SIZE
+        };
+        cairo_region_t *area = cairo_region_create_rectangle(&tile_rect);
+        gint n, r;
+
+        cairo_region_intersect(area, model_region);
+
+        if (tile->placeholder) {
+            /* Show what was there at the previous scale for now,
+             * and render the tile once this frame is out */
+            draw_placeholder(self, cr, tile->tile_x, tile->tile_y, area);
+            cairo_region_union(self->pending_region, area);
+            start_pending(self);
+            cairo_region_destroy(area);
+            complete = FALSE;
+            continue;
+        }
+
+        if (tile->needs_render)
+            insert_tile(self, tile);
+
+        cairo_set_source_surface(cr, tile->surface,
+                                 tile_rect.x - origin_x, tile_rect.y - origin_y);
+        n = cairo_region_num_rectangles(area);
+        for (r = 0; r < n; r++) {
+            cairo_rectangle_int_t rect;
+
+            cairo_region_get_rectangle(area, r, &rect);
+            cairo_rectangle(cr, rect.x - origin_x, rect.y - origin_y,
+                            rect.width, rect.height);
+        }
+        cairo_fill(cr);
+
+        cairo_region_destroy(area);
+        cairo_surface_destroy(tile->surface);
+    }
+
+    g_array_free(tiles, TRUE);
+    cairo_region_destroy(model_region);
+
+    /* Nothing left to catch up with, so later zooms can use these tiles
+     * as placeholders */
+    if (complete && cairo_region_is_empty(self->pending_region))
+        self->drawn_scale = self->scale;
+
+    if (trace_start) {
+        GeglRectangle drawn;
+
+        cairo_region_get_extents(region, &extents);
+        gegl_rectangle_set(&drawn, extents.x, extents.y, extents.width, extents.height);
+        trace_span("draw", trace_start, &drawn);
+    }
+}
+
+/* Draw the view of the GeglNode to the provided cairo context.
+ * @rect the area to draw in view coordinates
+ *
+ * Convenience for view_helper_draw_region() with a single rectangle */
+void
+view_helper_draw(ViewHelper *self, cairo_t *cr, GdkRectangle *rect)
+{
+    cairo_region_t *region;
+
+    if (rect->width <= 0 || rect->height <= 0)
+        return;
+
+    region = cairo_region_create_rectangle((cairo_rectangle_int_t *)rect);
+    view_helper_draw_region(self, cr, region);
+    cairo_region_destroy(region);
+}
+
+void
+view_helper_set_allocation(ViewHelper *self, GdkRectangle *allocation)
+{
+    self->widget_allocation = *allocation;
+    update_autoscale(self);
+    update_focus(self);
+    prune_invisible(self);
+    process_deferred(self);
+}
+
+/* Queue an area of the GeglNode for processing.
+ * Overlapping areas are merged, so that each pixel is processed once. */
+static void
+queue_processing(ViewHelper *self, GeglRectangle roi)
+{
+    cairo_rectangle_int_t area;
+
+    // Add the invalidated region to the dirty
+    to_cairo_rectangle(&roi, &area);
+    g_mutex_lock(&self->queue_mutex);
+    cairo_region_union_rectangle(self->processing_region, &area);
+    if (self->progressive && self->coarse_level > self->view_level)
+        cairo_region_union_rectangle(self->coarse_queue, &area);
+    if (self->worker)
+        g_cond_signal(&self->queue_cond);
+    g_mutex_unlock(&self->queue_mutex);
+
+    if (!self->worker)
+        start_monitor(self);
+}
+
+/* Trigger processing of the GeglNode
+ *
+ * Only the part of @roi which is visible in the view is processed right away.
+ * The rest is deferred until it is scrolled into view, see process_deferred() */
+void
+trigger_processing(ViewHelper *self, GeglRectangle roi)
+{
+    GeglRectangle visible, visible_roi;
+    cairo_rectangle_int_t area;
+    cairo_region_t *offscreen;
+
+    if (!self->node || roi.width <= 0 || roi.height <= 0)
+        return;
+
+    if (self->suspended) {
+        to_cairo_rectangle(&roi, &area);
+        cairo_region_union_rectangle(self->deferred_region, &area);
+        return;
+    }
+
+    if (!get_visible_model_rect(self, &visible)) {
+        /* No idea what is visible, process everything */
+        queue_processing(self, roi);
+        return;
+    }
+
+    if (gegl_rectangle_intersect(&visible_roi, &roi, &visible))
+        queue_processing(self, visible_roi);
+
+    to_cairo_rectangle(&roi, &area);
+    offscreen = cairo_region_create_rectangle(&area);
+    to_cairo_rectangle(&visible, &area);
+    cairo_region_subtract_rectangle(offscreen, &area);
+    cairo_region_union(self->deferred_region, offscreen);
+    cairo_region_destroy(offscreen);
+}
+
+/* Process the deferred dirty areas that have become visible,
+ * after the view transformation or allocation changed */
+static void
+process_deferred(ViewHelper *self)
+{
+    GeglRectangle visible;
+    cairo_rectangle_int_t visible_area;
+    cairo_region_t *now_visible;
+    gint i;
+
+    if (!self->node || self->suspended || cairo_region_is_empty(self->deferred_region))
+        return;
+
+    if (get_visible_model_rect(self, &visible)) {
+        to_cairo_rectangle(&visible, &visible_area);
+        now_visible = cairo_region_copy(self->deferred_region);
+        cairo_region_intersect_rectangle(now_visible, &visible_area);
+    } else {
+        now_visible = cairo_region_copy(self->deferred_region);
+    }
+
+    cairo_region_subtract(self->deferred_region, now_visible);
+
+    for (i = 0; i < cairo_region_num_rectangles(now_visible); i++) {
+        cairo_rectangle_int_t r;
+        GeglRectangle roi;
+
+        cairo_region_get_rectangle(now_visible, i, &r);
+        gegl_rectangle_set(&roi, r.x, r.y, r.width, r.height);
+        queue_processing(self, roi);
+    }
+
+    cairo_region_destroy(now_visible);
 }
 
 void
-view_helper_set_x(ViewHelper *self, float x)
+trigger_redraw(ViewHelper *self, GeglRectangle *redraw_rect)
+{
+  GeglRectangle invalid_rect = {0, 0, -1, -1}; /* Indicates full redraw */
+
+    if (self->suspended) {
+        /* Nothing is shown, redraw everything once resumed */
+        self->redraw_on_resume = TRUE;
+        return;
+    }
+
+    trace_instant("redraw", redraw_rect);
+
+    if (!redraw_rect) {
+        redraw_rect = &invalid_rect;
+    }
+
+    g_signal_emit(self, view_helper_signals[SIGNAL_REDRAW_NEEDED],
+                  0, redraw_rect, NULL);
+}
+
+/* Replace the tiles rendered while interactive with full quality ones */
+static void
+end_interaction(ViewHelper *self)
+{
+    guint i;
+
+    for (i = 0; i < self->interactive_tiles->len; i++) {
+        InteractiveTile *key = &g_array_index(self->interactive_tiles, InteractiveTile, i);
+
+        tile_cache_remove(self->tile_cache, key->scale, key->x, key->y);
+    }
+    g_array_set_size(self->interactive_tiles, 0);
+
+    trigger_redraw(self, NULL);
+}
+
+/* Make the view interactive if set so explicitly or automatically,
+ * and end the interaction once neither holds */
+static void
+update_interactive(ViewHelper *self)
+{
+    gboolean interactive = self->interactive_explicit || self->interactive_auto;
+
+    if (self->interactive == interactive)
+        return;
+
+    self->interactive = interactive;
+
+    if (!interactive)
+        end_interaction(self);
+
+    g_signal_emit(self, view_helper_signals[SIGNAL_INTERACTIVE_CHANGED],
+                  0, interactive, NULL);
+}
+
+static gboolean
+interaction_timeout(ViewHelper *self)
+{
+    self->interactive_id = 0;
+    self->interactive_auto = FALSE;
+    update_interactive(self);
+    return FALSE;
+}
+
+/* Changes in rapid succession, like during a drag or a zoom gesture,
+ * make the view interactive until things have been quiet for a while */
+static gboolean
+handle_transform_change(ViewHelper *self)
+{
+    gint64 now = g_get_monotonic_time();
+
+    self->transform_change_id = 0;
+
+    if (now - self->last_transform_time < INTERACTIVE_INTERVAL)
+        self->interactive_auto = TRUE;
+    self->last_transform_time = now;
+
+    if (self->interactive_auto) {
+        if (self->interactive_id)
+            g_source_remove(self->interactive_id);
+        self->interactive_id = g_timeout_add(INTERACTIVE_QUIET_PERIOD,
+                                             (GSourceFunc) interaction_timeout, self);
+        update_interactive(self);
+    }
+
+    return FALSE;
+}
+
+/* Called on every change of the view transformation.
+ * The changes made in one main loop iteration count as one, like setting
+ * x and y in turn, or autoscale correcting a new scale. So they are only
+ * handled once control is back in the main loop, ahead of redrawing. */
+static void
+note_transform_change(ViewHelper *self)
+{
+    if (self->transform_change_id == 0) {
+        self->transform_change_id = g_idle_add_full(G_PRIORITY_HIGH_IDLE,
+                                                    (GSourceFunc) handle_transform_change,
+                                                    self, NULL);
+    }
+}
+
+void
+view_helper_set_node(ViewHelper *self, GeglNode *node)
+{
+    if (self->node == node)
+        return;
+
+    if (self->node) {
+        g_signal_handler_disconnect (self->node, self->computed_id);
+        g_signal_handler_disconnect (self->node, self->invalidated_id);
+        g_object_unref(self->node);
+    }
+
+    tile_cache_clear(self->tile_cache);
+    cancel_processing(self);
+    self->bbox_valid = FALSE;
+    self->autoscale_size_valid = FALSE;
+
+    self->drawn_scale = 0.0;
+    cairo_region_destroy(self->pending_region);
+    self->pending_region = cairo_region_create();
+    g_array_set_size(self->interactive_tiles, 0);
+
+    /* Make the worker skip a job it may have taken for the previous node */
+    g_rec_mutex_lock(&self->process_mutex);
+    g_mutex_lock(&self->queue_mutex);
+    self->generation++;
+    g_mutex_unlock(&self->queue_mutex);
+    g_rec_mutex_unlock(&self->process_mutex);
+
+    if (node) {
+        g_object_ref(node);
+        self->node = node;
+
+        self->computed_id = g_signal_connect_object(self->node, "computed",
+                                                    G_CALLBACK(computed_event),
+                                                    self, 0);
+        self->invalidated_id = g_signal_connect_object(self->node, "invalidated",
+                                                       G_CALLBACK(invalidated_event),
+                                                       self, 0);
+
+        GeglRectangle bbox = get_bounding_box(self);
+
+        g_rec_mutex_lock(&self->process_mutex);
+        if (self->processor)
+            g_object_unref(self->processor);
+        self->processor = gegl_node_new_processor(self->node, &bbox);
+        g_rec_mutex_unlock(&self->process_mutex);
+
+        update_autoscale(self);
+        trigger_processing(self, bbox);
+
+    } else {
+        g_rec_mutex_lock(&self->process_mutex);
+        if (self->processor)
+            g_object_unref(self->processor);
+        self->processor = NULL;
+        g_rec_mutex_unlock(&self->process_mutex);
+
+        self->node = NULL;
+        self->computed_id = 0;
+        self->invalidated_id = 0;
+    }
+}
+
+GeglNode *
+view_helper_get_node(ViewHelper *self)
+{
+    return self->node;
+}
+
+/* Change the view transformation, all at once.
+ *
+ * A translation only shifts the pixels already drawn, so instead of
+ * redrawing everything the view is asked to scroll. The area that
+ * becomes exposed is then drawn, mostly from the tile cache.
+ * A scale change redraws the whole view, once.
+ *
+ * Emits "transformation-changed" when done */
+void
+view_helper_set_transform(ViewHelper *self, float x, float y, float scale)
 {
-    if (self->x == x)
+    gint old_origin_x = self->x;
+    gint old_origin_y = self->y;
+    gdouble old_scale = self->scale;
+    gint dx, dy;
+
+    /* Also rejects NaN */
+    if (!(scale >= VIEW_HELPER_MIN_SCALE))
+        scale = VIEW_HELPER_MIN_SCALE;
+    else if (scale > VIEW_HELPER_MAX_SCALE)
+        scale = VIEW_HELPER_MAX_SCALE;
+
+    if (self->x == x && self->y == y && self->scale == scale)
         return;
 
+    if (scale != old_scale) {
+        /* Tiles still pending belong to the previous scale. Placeholders
+         * keep coming from drawn_scale, which is only updated once a scale
+         * has been fully drawn, so zooming again before that is fine */
+        cairo_region_destroy(self->pending_region);
+        self->pending_region = cairo_region_create();
+    }
+
     self->x = x;
+    self->y = y;
+    self->scale = scale;
+    note_transform_change(self);
+    update_levels(self);
     update_autoscale(self);
-    trigger_redraw(self, NULL);
+
+    if (self->scale != scale) {
+        /* Autoscaling changed the scale again, and that change
+         * already took care of the rest */
+        return;
+    }
+
+    update_focus(self);
+    prune_invisible(self);
+    refine_lod(self);
+    process_deferred(self);
+
+    if (self->scale != old_scale || self->suspended) {
+        trigger_redraw(self, NULL);
+    } else {
+        dx = (gint)self->x - old_origin_x;
+        dy = (gint)self->y - old_origin_y;
+
+        /* Subpixel changes do not affect what is drawn */
+        if (dx != 0 || dy != 0)
+            g_signal_emit(self, view_helper_signals[SIGNAL_SCROLL_NEEDED],
+                          0, dx, dy, NULL);
+    }
+
+    g_signal_emit(self, view_helper_signals[SIGNAL_TRANSFORMATION_CHANGED], 0, NULL);
+}
+
+void
+view_helper_set_scale(ViewHelper *self, float scale)
+{
+    view_helper_set_transform(self, self->x, self->y, scale);
+}
+
+float
+view_helper_get_scale(ViewHelper *self)
+{
+    return self->scale;
+}
+
+void
+view_helper_set_x(ViewHelper *self, float x)
+{
+    view_helper_set_transform(self, x, self->y, self->scale);
 }
 
 float
@@ -410,12 +2028,7 @@ view_helper_get_x(ViewHelper *self)
 void
 view_helper_set_y(ViewHelper *self, float y)
 {
-    if (self->y == y)
-        return;
-
-    self->y = y;
-    update_autoscale(self);
-    trigger_redraw(self, NULL);
+    view_helper_set_transform(self, self->x, y, self->scale);
 }
 
 float
@@ -449,6 +2062,7 @@ view_helper_set_autoscale_policy(ViewHelper *self, GeglGtkViewAutoscale autoscal
         return;
 
     self->autoscale_policy = autoscale;
+    self->autoscale_size_valid = FALSE;
     update_autoscale(self);
 }
 
@@ -457,3 +2071,270 @@ view_helper_get_autoscale_policy(ViewHelper *self)
 {
     return self->autoscale_policy;
 }
+
+void
+view_helper_set_processing_priority(ViewHelper *self, gint priority)
+{
+    if (self->processing_priority == priority)
+        return;
+
+    self->processing_priority = priority;
+
+    /* Restart a running idle source, so the new priority takes effect */
+    if (self->monitor_id && !self->worker) {
+        g_source_remove(self->monitor_id);
+        self->monitor_id = 0;
+        start_monitor(self);
+    }
+}
+
+gint
+view_helper_get_processing_priority(ViewHelper *self)
+{
+    return self->processing_priority;
+}
+
+/* Set the time to spend processing per main loop iteration, in microseconds.
+ * A budget of 0 processes a single chunk per iteration. */
+void
+view_helper_set_processing_budget(ViewHelper *self, gint budget)
+{
+    self->processing_budget = budget;
+}
+
+gint
+view_helper_get_processing_budget(ViewHelper *self)
+{
+    return self->processing_budget;
+}
+
+/* In threaded mode the node is processed in a dedicated worker thread
+ * instead of in idle callbacks on the main loop.
+ * The graph must then only be modified from the main thread, between
+ * view_helper_lock_graph() and view_helper_unlock_graph(). */
+void
+view_helper_set_threaded(ViewHelper *self, gboolean threaded)
+{
+    gboolean has_work;
+
+    if (threaded == (self->worker != NULL))
+        return;
+
+    if (threaded) {
+        if (self->monitor_id) {
+            g_source_remove(self->monitor_id);
+            self->monitor_id = 0;
+        }
+        self->worker = g_thread_new("gegl-gtk-view", worker_thread, self);
+    } else {
+        stop_worker(self);
+
+        has_work = self->currently_processed_rect ||
+                   !cairo_region_is_empty(self->processing_region) ||
+                   !cairo_region_is_empty(self->coarse_queue);
+        if (has_work)
+            start_monitor(self);
+    }
+}
+
+gboolean
+view_helper_get_threaded(ViewHelper *self)
+{
+    return self->worker != NULL;
+}
+
+/* Track the pointer position in view coordinates,
+ * processing is prioritized around it while it is @inside the view */
+void
+view_helper_set_pointer(ViewHelper *self, gboolean inside, gfloat x, gfloat y)
+{
+    self->has_pointer = inside;
+    self->pointer_x = x;
+    self->pointer_y = y;
+    update_focus(self);
+}
+
+/* Set the number of threads used for rendering tiles.
+ * 0 uses the number of threads GEGL is configured with */
+void
+view_helper_set_render_threads(ViewHelper *self, gint threads)
+{
+    self->render_threads = threads;
+}
+
+gint
+view_helper_get_render_threads(ViewHelper *self)
+{
+    return self->render_threads;
+}
+
+/* In progressive mode, newly invalidated areas are first processed and
+ * drawn at a low level of detail, and then refined to full resolution.
+ * Gives quick feedback on graphs which are slow to process. */
+void
+view_helper_set_progressive(ViewHelper *self, gboolean progressive)
+{
+    g_mutex_lock(&self->queue_mutex);
+    self->progressive = progressive;
+    if (!progressive) {
+        cairo_region_destroy(self->coarse_queue);
+        self->coarse_queue = cairo_region_create();
+    }
+    g_mutex_unlock(&self->queue_mutex);
+}
+
+gboolean
+view_helper_get_progressive(ViewHelper *self)
+{
+    return self->progressive;
+}
+
+/* Set how the node is magnified when zoomed in beyond its resolution */
+void
+view_helper_set_filter(ViewHelper *self, GeglGtkViewFilter filter)
+{
+    if (self->filter == filter)
+        return;
+
+    self->filter = filter;
+
+    /* Magnified tiles look different now */
+    if (self->scale > 1.0) {
+        tile_cache_clear(self->tile_cache);
+        trigger_redraw(self, NULL);
+    }
+}
+
+GeglGtkViewFilter
+view_helper_get_filter(ViewHelper *self)
+{
+    return self->filter;
+}
+
+/* While interactive, tiles are rendered at reduced quality and processing
+ * yields to drawing, so that pans and zooms stay smooth regardless of the
+ * cost of the graph. When the interaction ends, the view is rendered again
+ * at full quality.
+ *
+ * Entered automatically on rapid transform changes, and left after a
+ * quiet period. Can also be set explicitly, for instance during a drag,
+ * in which case it lasts until unset. Unsetting also ends an automatic
+ * interaction right away. */
+void
+view_helper_set_interactive(ViewHelper *self, gboolean interactive)
+{
+    self->interactive_explicit = interactive;
+
+    if (!interactive) {
+        if (self->interactive_id) {
+            g_source_remove(self->interactive_id);
+            self->interactive_id = 0;
+        }
+        /* Changes made right before, like the last step of a drag,
+         * must not start an automatic interaction */
+        if (self->transform_change_id) {
+            g_source_remove(self->transform_change_id);
+            self->transform_change_id = 0;
+            self->last_transform_time = g_get_monotonic_time();
+        }
+        self->interactive_auto = FALSE;
+    }
+
+    update_interactive(self);
+}
+
+gboolean
+view_helper_get_interactive(ViewHelper *self)
+{
+    return self->interactive;
+}
+
+/* While suspended, nothing is processed and no redraws are requested.
+ * Dirty areas are deferred, and once resumed only the part of them that
+ * is visible is processed. Work already queued is deferred as well,
+ * and tiles drawn from placeholders are only rendered once resumed.
+ *
+ * Used by the widget to not start processing before it knows what is
+ * visible, that is until it has been mapped and allocated, and to not
+ * spend time on a view that cannot be seen. */
+void
+view_helper_set_suspended(ViewHelper *self, gboolean suspended)
+{
+    if (self->suspended == suspended)
+        return;
+
+    self->suspended = suspended;
+
+    if (suspended) {
+        defer_queued(self, NULL);
+        if (self->pending_id) {
+            g_source_remove(self->pending_id);
+            self->pending_id = 0;
+        }
+        return;
+    }
+
+    process_deferred(self);
+
+    if (!cairo_region_is_empty(self->pending_region))
+        start_pending(self);
+
+    if (self->redraw_on_resume) {
+        self->redraw_on_resume = FALSE;
+        trigger_redraw(self, NULL);
+    }
+}
+
+gboolean
+view_helper_get_suspended(ViewHelper *self)
+{
+    return self->suspended;
+}
+
+void
+view_helper_get_stats(ViewHelper *self, GeglGtkViewStats *stats)
+{
+    g_mutex_lock(&self->queue_mutex);
+    stats->queue_length = cairo_region_num_rectangles(self->processing_region) +
+                          cairo_region_num_rectangles(self->coarse_queue);
+    stats->progress = self->currently_processed_rect ? self->progress : 1.0;
+    g_mutex_unlock(&self->queue_mutex);
+
+    g_mutex_lock(&self->stats_mutex);
+    stats->exposes = self->stats_exposes;
+    stats->pixels_blitted = self->stats_pixels_blitted;
+    stats->blit_time = self->stats_blit_time;
+    stats->process_time = self->stats_process_time;
+    g_mutex_unlock(&self->stats_mutex);
+
+    stats->staging_bytes = surface_pool_get_total_bytes(self->surface_pool);
+}
+
+/* Only resets the counters, the queue length, progress
+ * and staging bytes reflect the current state */
+void
+view_helper_reset_stats(ViewHelper *self)
+{
+    g_mutex_lock(&self->stats_mutex);
+    self->stats_exposes = 0;
+    self->stats_pixels_blitted = 0;
+    self->stats_blit_time = 0;
+    self->stats_process_time = 0;
+    g_mutex_unlock(&self->stats_mutex);
+}
+
+/* Keep the worker thread and the render threads off the graph,
+ * so that it can be modified. Can be nested.
+ * The helper itself takes the lock whenever it accesses the graph
+ * from the main thread, so this must only be called from the main thread. */
+void
+view_helper_lock_graph(ViewHelper *self)
+{
+    g_rec_mutex_lock(&self->process_mutex);
+}
+
+void
+view_helper_unlock_graph(ViewHelper *self)
+{
+    g_rec_mutex_unlock(&self->process_mutex);
+}
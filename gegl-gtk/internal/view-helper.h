@@ -25,6 +25,10 @@
 #include <gtk/gtk.h>
 
 #include <gegl-gtk-enums.h>
+#include <gegl-gtk-view.h>
+
+#include "surface-pool.h"
+#include "tile-cache.h"
 
 G_BEGIN_DECLS
 
@@ -35,9 +39,24 @@ G_BEGIN_DECLS
 #define IS_VIEW_HELPER_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass),  VIEW_HELPER_TYPE))
 #define VIEW_HELPER_GET_CLASS(obj)  (G_TYPE_INSTANCE_GET_CLASS ((obj),  VIEW_HELPER_TYPE, ViewHelperClass))
 
+/* Coarsest level of detail the node is processed at */
+#define VIEW_HELPER_MAX_LEVEL 8
+
+/* Range of the scale. Beyond it, view and model coordinates
+ * of ordinary images would no longer fit in an int */
+#define VIEW_HELPER_MIN_SCALE 1e-4
+#define VIEW_HELPER_MAX_SCALE 1e4
+
 typedef struct _ViewHelper        ViewHelper;
 typedef struct _ViewHelperClass   ViewHelperClass;
 
+/* A tile rendered at reduced quality, while interactive */
+typedef struct {
+    gdouble scale;
+    gint    x;
+    gint    y;
+} InteractiveTile;
+
 struct _ViewHelper {
     GObject parent_instance;
 
@@ -47,14 +66,99 @@ struct _ViewHelper {
     gdouble        scale;
     gboolean       block;    /* blocking render */
     GeglGtkViewAutoscale autoscale_policy;
+    GeglRectangle  bbox;       /* Cached bounding box of the node */
+    gboolean       bbox_valid;
+    GeglRectangle  autoscale_size; /* Last size requested by autoscaling */
+    gboolean       autoscale_size_valid;
+    GeglGtkViewFilter filter; /* Used when zoomed in, see render_magnified_tile() */
 
     guint          monitor_id;
+    gint           processing_priority; /* Priority of the processing idle source */
+    gint           processing_budget;   /* Time to spend processing per iteration, in microseconds */
     GeglProcessor *processor;
-    GQueue        *processing_queue; /* Queue of rectangles that needs to be processed */
+    cairo_region_t *processing_region; /* Areas that need to be processed, in model coordinates */
     GeglRectangle *currently_processed_rect;
+    gint           current_level; /* Level of detail currently_processed_rect is processed at */
+    gboolean       current_coarse; /* currently_processed_rect is part of the coarse pass */
+    gint           view_level;     /* Level of detail matching the scale */
+    cairo_region_t *lod_region[VIEW_HELPER_MAX_LEVEL + 1]; /* Areas last processed at each level above 0 */
+    gboolean       progressive;     /* Process a coarse pass first, see take_next_rect() */
+    cairo_region_t *coarse_queue;   /* Areas waiting for the coarse pass, in model coordinates */
+    cairo_region_t *coarse_region;  /* Areas with only coarse results so far, in model coordinates */
+    gint           coarse_level;    /* Level of detail of the coarse pass, 0 if disabled */
+    gboolean       has_focus;  /* Work closest to the focus point is done first */
+    gdouble        focus_x;    /* In model coordinates */
+    gdouble        focus_y;
+    gboolean       has_pointer; /* Pointer position, in view coordinates */
+    gfloat         pointer_x;
+    gfloat         pointer_y;
+    cairo_region_t *deferred_region; /* Dirty areas outside the visible area, in model coordinates */
+    gboolean       suspended; /* All dirty areas are deferred, see view_helper_set_suspended() */
+    gboolean       redraw_on_resume; /* A redraw was requested while suspended */
 
     GdkRectangle   widget_allocation; /* The allocated size of the widget */
 
+    /* Whether the widget can be seen, maintained by GeglGtkView */
+    gboolean       pause_when_hidden; /* Suspend processing while hidden */
+    gboolean       widget_obscured;
+    gboolean       widget_iconified;
+
+    SurfacePool   *surface_pool; /* Staging surfaces, reused across draws */
+    TileCache     *tile_cache; /* Rendered tiles, reused across draws */
+
+    /* Threaded processing.
+     * queue_mutex protects processing_region, currently_processed_rect,
+     * the progressive rendering state, the focus point,
+     * computed_region and results_id. process_mutex is held while the
+     * GeglProcessor is working, while the node is blitted by processing
+     * it (reading only its cache needs no lock), and while the graph is
+     * accessed or modified from the main thread. It is recursive,
+     * as modifying the graph emits signals handled by the helper. */
+    GThread       *main_thread;
+    GThread       *worker;
+    gboolean       worker_quit;
+    GMutex         queue_mutex;
+    GCond          queue_cond;
+    GRecMutex      process_mutex;
+    guint          generation; /* Changes with the node, modified with both locks held */
+    cairo_region_t *computed_region; /* Computed by the worker, not yet dispatched */
+    guint          results_id;
+
+    /* Rendering tiles in parallel, see render_tiles() */
+    gint           render_threads; /* 0 for GEGL's setting */
+    GThreadPool   *render_pool;
+    GMutex         render_mutex;
+    GCond          render_cond;
+    gint           render_pending;
+
+    /* Drawing while zooming, see draw_placeholder() */
+    gdouble        drawn_scale;       /* Last scale the view was fully drawn at, 0 for none.
+                                       * Its tiles serve as placeholders at other scales */
+    cairo_region_t *pending_region;   /* Drawn from placeholders, in scaled model coordinates */
+    guint          pending_id;
+
+    /* Interaction, see view_helper_set_interactive() */
+    gboolean       interactive;          /* Either of the two below */
+    gboolean       interactive_explicit; /* Set with view_helper_set_interactive() */
+    gboolean       interactive_auto;     /* From rapid transform changes, ends when quiet */
+    gint64         last_transform_time;  /* Monotonic time of the last transform change */
+    guint          interactive_id;       /* Ends the automatic interaction after a quiet period */
+    guint          transform_change_id;  /* Handles the changes of one main loop iteration */
+    GArray        *interactive_tiles;    /* InteractiveTile, to render again at full quality */
+
+    /* Statistics, see view_helper_get_stats() */
+    GMutex         stats_mutex; /* Blits and processing happen in other threads */
+    guint64        stats_exposes;
+    guint64        stats_pixels_blitted;
+    guint64        stats_blit_time;
+    guint64        stats_process_time;
+    gdouble        progress; /* Of the processor on currently_processed_rect */
+
+    /* Widget state, used by GeglGtkView */
+    cairo_region_t *damage_region; /* Areas to redraw on the next frame, in view coordinates */
+    gboolean       damage_all;
+    guint          damage_tick_id;
+
     gulong computed_id;
     gulong invalidated_id;
 };
@@ -69,6 +173,7 @@ GType view_helper_get_type(void) G_GNUC_CONST;
 ViewHelper *view_helper_new(void);
 
 void view_helper_draw(ViewHelper *self, cairo_t *cr, GdkRectangle *rect);
+void view_helper_draw_region(ViewHelper *self, cairo_t *cr, const cairo_region_t *region);
 void view_helper_set_allocation(ViewHelper *self, GdkRectangle *allocation);
 
 void view_helper_set_node(ViewHelper *self, GeglNode *node);
@@ -83,11 +188,44 @@ float view_helper_get_x(ViewHelper *self);
 void view_helper_set_y(ViewHelper *self, float y);
 float view_helper_get_y(ViewHelper *self);
 
+void view_helper_set_transform(ViewHelper *self, float x, float y, float scale);
 void view_helper_get_transformation(ViewHelper *self, GeglMatrix3 *matrix);
 
 void view_helper_set_autoscale_policy(ViewHelper *self, GeglGtkViewAutoscale autoscale);
 GeglGtkViewAutoscale view_helper_get_autoscale_policy(ViewHelper *self);
 
+void view_helper_set_filter(ViewHelper *self, GeglGtkViewFilter filter);
+GeglGtkViewFilter view_helper_get_filter(ViewHelper *self);
+
+void view_helper_set_processing_priority(ViewHelper *self, gint priority);
+gint view_helper_get_processing_priority(ViewHelper *self);
+
+void view_helper_set_processing_budget(ViewHelper *self, gint budget);
+gint view_helper_get_processing_budget(ViewHelper *self);
+
+void view_helper_set_pointer(ViewHelper *self, gboolean inside, gfloat x, gfloat y);
+
+void view_helper_set_render_threads(ViewHelper *self, gint threads);
+gint view_helper_get_render_threads(ViewHelper *self);
+
+void view_helper_set_progressive(ViewHelper *self, gboolean progressive);
+gboolean view_helper_get_progressive(ViewHelper *self);
+
+void view_helper_set_interactive(ViewHelper *self, gboolean interactive);
+gboolean view_helper_get_interactive(ViewHelper *self);
+
+void view_helper_set_threaded(ViewHelper *self, gboolean threaded);
+gboolean view_helper_get_threaded(ViewHelper *self);
+
+void view_helper_set_suspended(ViewHelper *self, gboolean suspended);
+gboolean view_helper_get_suspended(ViewHelper *self);
+
+void view_helper_lock_graph(ViewHelper *self);
+void view_helper_unlock_graph(ViewHelper *self);
+
+void view_helper_get_stats(ViewHelper *self, GeglGtkViewStats *stats);
+void view_helper_reset_stats(ViewHelper *self);
+
 G_END_DECLS
 
 #endif /* __VIEW_HELPER_H__ */
@@ -26,6 +26,9 @@
 property_string (window_title, _("Window Title"), "")
   description (_("Title to give window, if no title given inherits name of the pad providing input."))
 
+property_boolean (pause_when_hidden, _("Pause when hidden"), TRUE)
+  description (_("Stop processing while the window is minimized or hidden."))
+
 #else
 
 #define GEGL_OP_NO_SOURCE
@@ -48,6 +51,15 @@ typedef struct {
     gint       height;
 } Priv;
 
+static void
+pause_when_hidden_changed(GeglOperation *operation, GParamSpec *pspec, Priv *priv)
+{
+    GeglProperties *o = GEGL_PROPERTIES(operation);
+
+    g_object_set(G_OBJECT(priv->view_widget),
+                 "pause-when-hidden", o->pause_when_hidden, NULL);
+}
+
 static Priv *
 init_priv(GeglOperation *operation)
 {
@@ -67,6 +79,11 @@ init_priv(GeglOperation *operation)
         gtk_widget_set_size_request(priv->view_widget, priv->width, priv->height);
         gtk_window_set_title(GTK_WINDOW(priv->window), o->window_title);
 
+        g_object_set(G_OBJECT(priv->view_widget),
+                     "pause-when-hidden", o->pause_when_hidden, NULL);
+        g_signal_connect(operation, "notify::pause-when-hidden",
+                         G_CALLBACK(pause_when_hidden_changed), priv);
+
         priv->node = NULL;
         priv->input = NULL;
 
@@ -128,6 +145,7 @@ dispose(GObject *object)
     Priv       *priv = (Priv *)o->user_data;
 
     if (priv) {
+        g_signal_handlers_disconnect_by_func(object, pause_when_hidden_changed, priv);
         gtk_widget_destroy(priv->window);
         g_free(priv);
         o->user_data = NULL;
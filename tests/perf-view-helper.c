@@ -0,0 +1,450 @@
+/* This file is part of GEGL-GTK
+ *
+ * GEGL-GTK is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * GEGL-GTK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GEGL-GTK; if not, see <http://www.gnu.org/licenses/>.
+ *
+ * Copyright (C) 2026 The GEGL-GTK authors
+ */
+
+/*
+ * Benchmarks for ViewHelper.
+ *
+ * Draw throughput:
+ * Draws the view into an offscreen cairo image surface, so no display
+ * server is needed. Every combination of image size, source format,
+ * scale, offset and number of render threads is measured with a cold
+ * tile cache, which exercises the render path, and with a warm one,
+ * which only composites.
+ *
+ * Invalidation storm:
+ * Fires thousands of small overlapping invalidations, the way a paint
+ * stroke does, at a graph with a fixed per-pixel cost. Measures how deep
+ * the processing queue gets, how many pixels are processed compared to
+ * how many were dirtied, and how long it takes until processing is idle.
+ *
+ * Each measurement is printed as one JSON object per line, and the
+ * headline numbers are also recorded as gtester performance results.
+ *
+ * The full matrix only runs in perf mode, for instance with
+ * "make perf-report" or "perf-view-helper -m perf". Otherwise a small
+ * subset runs as a smoke test.
+ */
+
+#include <math.h>
+
+#include <glib.h>
+#include <gegl.h>
+
+#include <internal/view-helper.h>
+
+#define VIEWPORT_WIDTH  1024
+#define VIEWPORT_HEIGHT 768
+#define PERF_ITERATIONS 20
+
+typedef struct {
+    gint x;
+    gint y;
+} ViewOffset;
+
+typedef struct {
+    const gchar *name; /* For the test path */
+    const gchar *format;
+} SourceFormat;
+
+static const gint image_sizes[] = { 512, 2048, 4096 };
+static const SourceFormat source_formats[] = {
+    { "rgb-u8", "R'G'B' u8" },
+    { "rgba-u8", "R'G'B'A u8" },
+    { "rgba-float", "RGBA float" }
+};
+static const gdouble scales[] = { 0.25, 0.5, 1.0, 1.5, 3.0 };
+static const ViewOffset offsets[] = { {0, 0}, {333, 211} };
+static const gint render_threads[] = { 1, 2, 4 };
+
+typedef struct {
+    gint size;
+    const gchar *format;
+} DrawBenchmark;
+
+typedef struct {
+    ViewHelper *helper;
+    GeglNode *graph, *out;
+    GeglBuffer *buffer;
+} DrawBenchmarkState;
+
+/* Fill the buffer with a gradient, so that no format conversion
+ * or blit can take a shortcut for uniform data */
+static void
+fill_source_buffer(GeglBuffer *buffer, gint size)
+{
+    guchar *pixels;
+    gint stride;
+    gint x, y;
+
+    pixels = gegl_buffer_linear_open(buffer, NULL, &stride, babl_format("R'G'B'A u8"));
+    for (y = 0; y < size; y++) {
+        guchar *row = pixels + y * stride;
+
+        for (x = 0; x < size; x++) {
+            row[x * 4 + 0] = x & 0xff;
+            row[x * 4 + 1] = y & 0xff;
+            row[x * 4 + 2] = (x ^ y) & 0xff;
+            row[x * 4 + 3] = 0xff;
+        }
+    }
+    gegl_buffer_linear_close(buffer, pixels);
+}
+
+static void
+setup_benchmark(DrawBenchmarkState *state, const DrawBenchmark *benchmark)
+{
+    GeglRectangle rect = {0, 0, benchmark->size, benchmark->size};
+    GdkRectangle allocation = {0, 0, VIEWPORT_WIDTH, VIEWPORT_HEIGHT};
+    GeglNode *loadbuf;
+
+    state->buffer = gegl_buffer_new(&rect, babl_format(benchmark->format));
+    fill_source_buffer(state->buffer, benchmark->size);
+
+    state->graph = gegl_node_new();
+    loadbuf = gegl_node_new_child(state->graph,
+                                  "operation", "gegl:buffer-source",
+                                  "buffer", state->buffer, NULL);
+    state->out = gegl_node_new_child(state->graph, "operation", "gegl:nop", NULL);
+    gegl_node_link_many(loadbuf, state->out, NULL);
+
+    state->helper = view_helper_new();
+    view_helper_set_autoscale_policy(state->helper, GEGL_GTK_VIEW_AUTOSCALE_DISABLED);
+    view_helper_set_allocation(state->helper, &allocation);
+    view_helper_set_node(state->helper, state->out);
+
+    /* Only the draw path is measured, not processing. The view is not
+     * blocking, as that would render the tiles one after the other */
+    state->helper->block = FALSE;
+    gegl_node_process(state->out);
+    while (g_main_context_iteration(NULL, FALSE));
+}
+
+static void
+teardown_benchmark(DrawBenchmarkState *state)
+{
+    g_object_unref(state->helper);
+    g_object_unref(state->graph);
+    g_object_unref(state->buffer);
+}
+
+static gint
+compare_double(gconstpointer a, gconstpointer b)
+{
+    const gdouble da = *(const gdouble *)a;
+    const gdouble db = *(const gdouble *)b;
+
+    return (da > db) - (da < db);
+}
+
+/* Nearest-rank percentile of sorted @latencies */
+static gdouble
+percentile(GArray *latencies, gdouble p)
+{
+    gint rank = (gint)ceil(p * latencies->len) - 1;
+
+    rank = CLAMP(rank, 0, (gint)latencies->len - 1);
+    return g_array_index(latencies, gdouble, rank);
+}
+
+static void
+report(const DrawBenchmark *benchmark, gdouble scale, const ViewOffset *offset,
+       gint threads, const gchar *cache, GArray *latencies)
+{
+    gdouble total = 0.0;
+    gdouble megapixels_per_second;
+    guint i;
+
+    for (i = 0; i < latencies->len; i++)
+        total += g_array_index(latencies, gdouble, i);
+
+    g_array_sort(latencies, compare_double);
+    megapixels_per_second = total > 0.0 ?
+                            (gdouble)VIEWPORT_WIDTH * VIEWPORT_HEIGHT * latencies->len / total / 1e6 :
+                            0.0;
+
+    g_print("{\"benchmark\": \"draw\", \"size\": %d, \"format\": \"%s\", "
+            "\"scale\": %g, \"x\": %d, \"y\": %d, \"threads\": %d, \"cache\": \"%s\", "
+            "\"iterations\": %u, \"mpix_per_s\": %.2f, "
+            "\"p50_ms\": %.3f, \"p90_ms\": %.3f, \"p99_ms\": %.3f, \"max_ms\": %.3f}\n",
+            benchmark->size, benchmark->format,
+            scale, offset->x, offset->y, threads, cache,
+            latencies->len, megapixels_per_second,
+            percentile(latencies, 0.50) * 1000.0,
+            percentile(latencies, 0.90) * 1000.0,
+            percentile(latencies, 0.99) * 1000.0,
+            g_array_index(latencies, gdouble, latencies->len - 1) * 1000.0);
+
+    g_test_maximized_result(megapixels_per_second,
+                            "draw %dpx %s scale=%g offset=%d,%d threads=%d %s cache: %.2f Mpix/s",
+                            benchmark->size, benchmark->format, scale,
+                            offset->x, offset->y, threads, cache, megapixels_per_second);
+}
+
+/* Draw the full viewport @iterations times, optionally clearing
+ * the tile cache before each draw */
+static void
+measure(DrawBenchmarkState *state, cairo_t *cr, gboolean cold,
+        gint iterations, GArray *latencies)
+{
+    GdkRectangle viewport = {0, 0, VIEWPORT_WIDTH, VIEWPORT_HEIGHT};
+    GTimer *timer = g_timer_new();
+    gint i;
+
+    g_array_set_size(latencies, 0);
+
+    for (i = 0; i < iterations; i++) {
+        gdouble elapsed;
+
+        if (cold)
+            tile_cache_clear(state->helper->tile_cache);
+
+        g_timer_start(timer);
+        view_helper_draw(state->helper, cr, &viewport);
+        cairo_surface_flush(cairo_get_target(cr));
+        elapsed = g_timer_elapsed(timer, NULL);
+
+        g_array_append_val(latencies, elapsed);
+    }
+
+    g_timer_destroy(timer);
+}
+
+static void
+test_draw_throughput(gconstpointer data)
+{
+    const DrawBenchmark *benchmark = data;
+    DrawBenchmarkState state;
+    cairo_surface_t *surface;
+    cairo_t *cr;
+    GArray *latencies;
+    gint iterations = g_test_perf() ? PERF_ITERATIONS : 1;
+    guint s, o, t;
+
+    setup_benchmark(&state, benchmark);
+
+    surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, VIEWPORT_WIDTH, VIEWPORT_HEIGHT);
+    cr = cairo_create(surface);
+    latencies = g_array_new(FALSE, FALSE, sizeof(gdouble));
+
+    for (s = 0; s < G_N_ELEMENTS(scales); s++) {
+        for (o = 0; o < G_N_ELEMENTS(offsets); o++) {
+            view_helper_set_transform(state.helper, offsets[o].x, offsets[o].y, scales[s]);
+            /* Back to back transform changes make the view interactive,
+             * which would render at reduced quality */
+            view_helper_set_interactive(state.helper, FALSE);
+            /* Let placeholders and deferred work from the transform settle */
+            while (g_main_context_iteration(NULL, FALSE));
+
+            for (t = 0; t < G_N_ELEMENTS(render_threads); t++) {
+                view_helper_set_render_threads(state.helper, render_threads[t]);
+
+                measure(&state, cr, TRUE, iterations, latencies);
+                report(benchmark, scales[s], &offsets[o], render_threads[t], "cold", latencies);
+
+                measure(&state, cr, FALSE, iterations, latencies);
+                report(benchmark, scales[s], &offsets[o], render_threads[t], "warm", latencies);
+            }
+        }
+    }
+
+    g_assert_cmpint(cairo_status(cr), ==, CAIRO_STATUS_SUCCESS);
+
+    g_array_free(latencies, TRUE);
+    cairo_destroy(cr);
+    cairo_surface_destroy(surface);
+    teardown_benchmark(&state);
+}
+
+#define STROKE_IMAGE_SIZE 1024
+#define STROKE_DAB_SIZE 32
+#define STROKE_DABS_PER_FRAME 16 /* Invalidations arriving per main loop iteration */
+
+typedef struct {
+    gint    max_queue_rects;
+    guint64 max_queue_pixels;
+    guint64 processed_pixels;
+} StormState;
+
+static guint64
+region_area(cairo_region_t *region)
+{
+    guint64 area = 0;
+    gint i;
+
+    for (i = 0; i < cairo_region_num_rectangles(region); i++) {
+        cairo_rectangle_int_t r;
+
+        cairo_region_get_rectangle(region, i, &r);
+        area += (guint64)r.width * r.height;
+    }
+    return area;
+}
+
+static void
+storm_computed(GeglNode *node, GeglRectangle *rect, StormState *state)
+{
+    state->processed_pixels += (guint64)rect->width * rect->height;
+}
+
+static void
+sample_queue(ViewHelper *helper, StormState *state)
+{
+    gint rects = cairo_region_num_rectangles(helper->processing_region);
+    guint64 pixels = region_area(helper->processing_region);
+
+    state->max_queue_rects = MAX(state->max_queue_rects, rects);
+    state->max_queue_pixels = MAX(state->max_queue_pixels, pixels);
+}
+
+static void
+test_invalidation_storm(void)
+{
+    GeglRectangle rect = {0, 0, STROKE_IMAGE_SIZE, STROKE_IMAGE_SIZE};
+    GdkRectangle allocation = {0, 0, STROKE_IMAGE_SIZE, STROKE_IMAGE_SIZE};
+    GeglBuffer *buffer;
+    GeglNode *graph, *loadbuf, *cost, *out;
+    ViewHelper *helper;
+    StormState state = { 0, 0, 0 };
+    cairo_region_t *dirtied;
+    guint64 dirtied_pixels;
+    gint dabs = g_test_perf() ? 5000 : 200;
+    GTimer *timer;
+    gdouble time_to_idle;
+    gint i;
+
+    buffer = gegl_buffer_new(&rect, babl_format("RGBA float"));
+    fill_source_buffer(buffer, STROKE_IMAGE_SIZE);
+
+    /* A point operation, so the cost of processing is the same for every pixel */
+    graph = gegl_node_new();
+    loadbuf = gegl_node_new_child(graph, "operation", "gegl:buffer-source",
+                                  "buffer", buffer, NULL);
+    cost = gegl_node_new_child(graph, "operation", "gegl:brightness-contrast",
+                               "contrast", 1.2, "brightness", 0.1, NULL);
+    out = gegl_node_new_child(graph, "operation", "gegl:nop", NULL);
+    gegl_node_link_many(loadbuf, cost, out, NULL);
+
+    helper = view_helper_new();
+    view_helper_set_autoscale_policy(helper, GEGL_GTK_VIEW_AUTOSCALE_DISABLED);
+    view_helper_set_allocation(helper, &allocation);
+    view_helper_set_node(helper, out);
+
+    /* Start from an idle view */
+    while (helper->monitor_id != 0)
+        g_main_context_iteration(NULL, TRUE);
+
+    g_signal_connect(out, "computed", G_CALLBACK(storm_computed), &state);
+    dirtied = cairo_region_create();
+    timer = g_timer_new();
+
+    /* A stroke of overlapping dabs, looping around the image */
+    for (i = 0; i < dabs; i++) {
+        gdouble t = (gdouble)i / dabs;
+        GeglRectangle dab;
+        cairo_rectangle_int_t area;
+
+        dab.x = (STROKE_IMAGE_SIZE - STROKE_DAB_SIZE) * (0.5 + 0.45 * sin(t * 2 * G_PI * 3));
+        dab.y = (STROKE_IMAGE_SIZE - STROKE_DAB_SIZE) * (0.5 + 0.45 * cos(t * 2 * G_PI * 2));
+        dab.width = STROKE_DAB_SIZE;
+        dab.height = STROKE_DAB_SIZE;
+
+        /* Dirty the costly node itself, as painting into its input would.
+         * The invalidation propagates to the output, where the view sees it */
+        gegl_node_invalidated(cost, &dab, FALSE);
+
+        area.x = dab.x;
+        area.y = dab.y;
+        area.width = dab.width;
+        area.height = dab.height;
+        cairo_region_union_rectangle(dirtied, &area);
+
+        sample_queue(helper, &state);
+        if (i % STROKE_DABS_PER_FRAME == STROKE_DABS_PER_FRAME - 1)
+            g_main_context_iteration(NULL, FALSE);
+    }
+
+    while (helper->monitor_id != 0) {
+        sample_queue(helper, &state);
+        g_main_context_iteration(NULL, TRUE);
+    }
+    time_to_idle = g_timer_elapsed(timer, NULL);
+
+    dirtied_pixels = region_area(dirtied);
+
+    g_print("{\"benchmark\": \"invalidation-storm\", \"dabs\": %d, \"dab_size\": %d, "
+            "\"max_queue_rects\": %d, \"max_queue_pixels\": %" G_GUINT64_FORMAT ", "
+            "\"dirtied_pixels\": %" G_GUINT64_FORMAT ", \"processed_pixels\": %" G_GUINT64_FORMAT ", "
+            "\"redundancy\": %.3f, \"time_to_idle_ms\": %.3f}\n",
+            dabs, STROKE_DAB_SIZE,
+            state.max_queue_rects, state.max_queue_pixels,
+            dirtied_pixels, state.processed_pixels,
+            (gdouble)state.processed_pixels / dirtied_pixels,
+            time_to_idle * 1000.0);
+
+    g_test_minimized_result((gdouble)state.processed_pixels / dirtied_pixels,
+                            "invalidation storm: %.3f pixels processed per pixel dirtied",
+                            (gdouble)state.processed_pixels / dirtied_pixels);
+    g_test_minimized_result(time_to_idle,
+                            "invalidation storm: %.3f ms until idle", time_to_idle * 1000.0);
+
+    /* Everything that was dirtied got processed */
+    g_assert(cairo_region_is_empty(helper->processing_region));
+    g_assert_cmpuint(state.processed_pixels, >=, dirtied_pixels);
+
+    g_timer_destroy(timer);
+    cairo_region_destroy(dirtied);
+    g_object_unref(helper);
+    g_object_unref(graph);
+    g_object_unref(buffer);
+}
+
+int
+main(int argc, char **argv)
+{
+    int retval = -1;
+    DrawBenchmark benchmarks[G_N_ELEMENTS(image_sizes) * G_N_ELEMENTS(source_formats)];
+    guint i, f;
+
+    gegl_init(&argc, &argv);
+    g_test_init(&argc, &argv, NULL);
+
+    for (i = 0; i < G_N_ELEMENTS(image_sizes); i++) {
+        /* Outside of perf mode, only the smallest size is a quick smoke test */
+        if (!g_test_perf() && i > 0)
+            break;
+
+        for (f = 0; f < G_N_ELEMENTS(source_formats); f++) {
+            DrawBenchmark *benchmark = &benchmarks[i * G_N_ELEMENTS(source_formats) + f];
+            gchar *path;
+
+            benchmark->size = image_sizes[i];
+            benchmark->format = source_formats[f].format;
+
+            path = g_strdup_printf("/widgets/view/helper/perf/draw/%d/%s",
+                                   image_sizes[i], source_formats[f].name);
+            g_test_add_data_func(path, benchmark, test_draw_throughput);
+            g_free(path);
+        }
+    }
+
+    g_test_add_func("/widgets/view/helper/perf/invalidation-storm", test_invalidation_storm);
+
+    retval = g_test_run();
+    gegl_exit();
+    return retval;
+}
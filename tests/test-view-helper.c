@@ -32,8 +32,9 @@ typedef struct {
 } ViewHelperTest;
 
 
+/* Setup the graph, and hook up its output node to the existing helper */
 static void
-setup_helper_test(ViewHelperTest *test)
+setup_helper_test_node(ViewHelperTest *test)
 {
     gpointer buf;
     GeglRectangle rect = {0, 0, 512, 512};
@@ -52,9 +53,15 @@ setup_helper_test(ViewHelperTest *test)
     test->out  = gegl_node_new_child(test->graph, "operation", "gegl:nop", NULL);
     gegl_node_link_many(test->loadbuf, test->out, NULL);
 
+    view_helper_set_node(test->helper, test->out);
+}
+
+static void
+setup_helper_test(ViewHelperTest *test)
+{
     /* Setup the GeglView helper, hook up the output node to it */
     test->helper = view_helper_new();
-    view_helper_set_node(test->helper, test->out);
+    setup_helper_test_node(test);
 }
 
 static void
@@ -192,6 +199,1167 @@ test_redraw_combined()
     test_redraw_on_computed (-10, -10, 2.0, &computed_rect, &redraw_rect);
 }
 
+/* Test that drawing fills the tile cache, and that invalidating
+ * the node only evicts the tiles which cover the invalidated area. */
+static void
+test_tile_cache(void)
+{
+    ViewHelperTest test;
+    cairo_surface_t *surface;
+    cairo_t *cr;
+    GdkRectangle draw_rect = {0, 0, 256, 256};
+    GeglRectangle invalidated_rect = {0, 0, 10, 10};
+
+    setup_helper_test(&test);
+    while (gtk_events_pending()) {
+        gtk_main_iteration();
+    }
+    gegl_node_process(test.out);
+
+    surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 256, 256);
+    cr = cairo_create(surface);
+
+    view_helper_draw(test.helper, cr, &draw_rect);
+    g_assert_cmpint(tile_cache_get_size(test.helper->tile_cache), ==, 4);
+
+    /* Drawing the same area again should be served from the cache */
+    view_helper_draw(test.helper, cr, &draw_rect);
+    g_assert_cmpint(tile_cache_get_size(test.helper->tile_cache), ==, 4);
+    g_assert(tile_cache_lookup(test.helper->tile_cache, 1.0, 0, 0));
+
+    gegl_node_invalidated(test.out, &invalidated_rect, FALSE);
+    g_assert(!tile_cache_lookup(test.helper->tile_cache, 1.0, 0, 0));
+    g_assert(tile_cache_lookup(test.helper->tile_cache, 1.0, 1, 1));
+    g_assert_cmpint(tile_cache_get_size(test.helper->tile_cache), ==, 3);
+
+    cairo_destroy(cr);
+    cairo_surface_destroy(surface);
+    teardown_helper_test(&test);
+}
+
+/* Test that the least recently used tile is evicted when the cache is full,
+ * and that tiles far from the origin are stored and found */
+static void
+test_tile_cache_eviction(void)
+{
+    SurfacePool *pool = surface_pool_new(SURFACE_POOL_MAX_BYTES);
+    TileCache *cache = tile_cache_new(2, pool);
+    cairo_surface_t *surface;
+    gint i;
+
+    for (i = 0; i < 3; i++) {
+        surface = surface_pool_acquire(pool, TILE_CACHE_TILE_SIZE, TILE_CACHE_TILE_SIZE);
+        tile_cache_insert(cache, 1.0, i * 100000, -i * 100000, surface);
+        cairo_surface_destroy(surface);
+
+        /* Keep the first tile in use */
+        g_assert(tile_cache_lookup(cache, 1.0, 0, 0));
+    }
+
+    g_assert_cmpint(tile_cache_get_size(cache), ==, 2);
+    g_assert(tile_cache_lookup(cache, 1.0, 0, 0));
+    g_assert(!tile_cache_lookup(cache, 1.0, 100000, -100000));
+    g_assert(tile_cache_lookup(cache, 1.0, 200000, -200000));
+
+    tile_cache_free(cache);
+    surface_pool_free(pool);
+}
+
+/* Test that drawing and processing are counted, and that resetting
+ * the statistics clears the counters */
+static void
+test_stats(void)
+{
+    ViewHelperTest test;
+    GeglGtkViewStats stats;
+    cairo_surface_t *surface;
+    cairo_t *cr;
+    GdkRectangle draw_rect = {0, 0, 256, 256};
+
+    setup_helper_test(&test);
+    while (gtk_events_pending()) {
+        gtk_main_iteration();
+    }
+
+    view_helper_get_stats(test.helper, &stats);
+    g_assert_cmpuint(stats.queue_length, ==, 0);
+    g_assert_cmpfloat(stats.progress, ==, 1.0);
+
+    surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 256, 256);
+    cr = cairo_create(surface);
+    view_helper_draw(test.helper, cr, &draw_rect);
+    /* Served from the tile cache, without blitting */
+    view_helper_draw(test.helper, cr, &draw_rect);
+    cairo_destroy(cr);
+    cairo_surface_destroy(surface);
+
+    view_helper_get_stats(test.helper, &stats);
+    g_assert_cmpuint(stats.exposes, ==, 2);
+    g_assert_cmpuint(stats.pixels_blitted, ==, 256 * 256);
+    /* The four cached tiles count as well */
+    g_assert_cmpuint(stats.staging_bytes, >=,
+                     4 * TILE_CACHE_TILE_SIZE * TILE_CACHE_TILE_SIZE * 4);
+
+    view_helper_reset_stats(test.helper);
+    view_helper_get_stats(test.helper, &stats);
+    g_assert_cmpuint(stats.exposes, ==, 0);
+    g_assert_cmpuint(stats.pixels_blitted, ==, 0);
+    g_assert_cmpuint(stats.blit_time, ==, 0);
+    g_assert_cmpuint(stats.process_time, ==, 0);
+
+    teardown_helper_test(&test);
+}
+
+/* Test that tiles rendered in parallel match the ones rendered serially */
+static void
+test_parallel_draw(void)
+{
+    ViewHelperTest test;
+    cairo_surface_t *serial, *parallel;
+    cairo_t *cr;
+    GdkRectangle draw_rect = {10, 10, 400, 300};
+
+    setup_helper_test(&test);
+    while (gtk_events_pending()) {
+        gtk_main_iteration();
+    }
+    gegl_node_process(test.out);
+
+    serial = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 400, 300);
+    parallel = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 400, 300);
+
+    view_helper_set_render_threads(test.helper, 1);
+    cr = cairo_create(serial);
+    cairo_translate(cr, -draw_rect.x, -draw_rect.y);
+    view_helper_draw(test.helper, cr, &draw_rect);
+    cairo_destroy(cr);
+
+    tile_cache_clear(test.helper->tile_cache);
+
+    view_helper_set_render_threads(test.helper, 4);
+    cr = cairo_create(parallel);
+    cairo_translate(cr, -draw_rect.x, -draw_rect.y);
+    view_helper_draw(test.helper, cr, &draw_rect);
+    cairo_destroy(cr);
+
+    g_assert_cmpint(tile_cache_get_size(test.helper->tile_cache), ==, 12);
+
+    cairo_surface_flush(serial);
+    cairo_surface_flush(parallel);
+    g_assert(memcmp(cairo_image_surface_get_data(serial),
+                    cairo_image_surface_get_data(parallel),
+                    cairo_image_surface_get_stride(serial) * 300) == 0);
+
+    cairo_surface_destroy(serial);
+    cairo_surface_destroy(parallel);
+    teardown_helper_test(&test);
+}
+
+/* Test that drawing a region only renders the tiles under its rectangles,
+ * not everything in its bounding box */
+static void
+test_draw_region(void)
+{
+    ViewHelperTest test;
+    cairo_surface_t *surface;
+    cairo_t *cr;
+    cairo_region_t *region;
+    cairo_rectangle_int_t top_left = {0, 0, 10, 10};
+    cairo_rectangle_int_t bottom_right = {500, 500, 10, 10};
+
+    setup_helper_test(&test);
+    while (gtk_events_pending()) {
+        gtk_main_iteration();
+    }
+    gegl_node_process(test.out);
+
+    surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 512, 512);
+    cr = cairo_create(surface);
+
+    region = cairo_region_create_rectangle(&top_left);
+    cairo_region_union_rectangle(region, &bottom_right);
+
+    view_helper_draw_region(test.helper, cr, region);
+    g_assert_cmpint(tile_cache_get_size(test.helper->tile_cache), ==, 2);
+    g_assert(tile_cache_lookup(test.helper->tile_cache, 1.0, 0, 0));
+    g_assert(tile_cache_lookup(test.helper->tile_cache, 1.0, 3, 3));
+
+    cairo_region_destroy(region);
+    cairo_destroy(cr);
+    cairo_surface_destroy(surface);
+    teardown_helper_test(&test);
+}
+
+/* Test that right after zooming, the view is drawn from the tiles of the
+ * previous scale, and that the tiles for the new scale are rendered later. */
+static void
+test_zoom_placeholder(void)
+{
+    ViewHelperTest test;
+    cairo_surface_t *surface;
+    cairo_t *cr;
+    GdkRectangle draw_rect = {0, 0, 256, 256};
+    guint32 *pixel;
+
+    setup_helper_test(&test);
+    while (gtk_events_pending()) {
+        gtk_main_iteration();
+    }
+    gegl_node_process(test.out);
+
+    view_helper_set_autoscale_policy(test.helper, GEGL_GTK_VIEW_AUTOSCALE_DISABLED);
+
+    surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 256, 256);
+    cr = cairo_create(surface);
+    view_helper_draw(test.helper, cr, &draw_rect);
+    cairo_destroy(cr);
+
+    view_helper_set_scale(test.helper, 2.0);
+
+    cr = cairo_create(surface);
+    cairo_set_source_rgba(cr, 0.0, 0.0, 0.0, 0.0);
+    cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+    cairo_paint(cr);
+    cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+    view_helper_draw(test.helper, cr, &draw_rect);
+    cairo_destroy(cr);
+
+    /* Drawn from the placeholders, not rendered */
+    g_assert(!tile_cache_lookup(test.helper->tile_cache, 2.0, 0, 0));
+    g_assert(!cairo_region_is_empty(test.helper->pending_region));
+    cairo_surface_flush(surface);
+    pixel = (guint32 *)cairo_image_surface_get_data(surface);
+    g_assert_cmphex(pixel[0], ==, 0xffffffff);
+
+    g_timeout_add(300, test_utils_quit_gtk_main, NULL);
+    gtk_main();
+
+    g_assert(tile_cache_lookup(test.helper->tile_cache, 2.0, 0, 0));
+    g_assert(cairo_region_is_empty(test.helper->pending_region));
+
+    cairo_surface_destroy(surface);
+    teardown_helper_test(&test);
+}
+
+/* Test that zooming twice before drawing still draws from the tiles of
+ * the last scale that was fully drawn, and that the scale reached is
+ * only used for placeholders once its tiles have all been rendered. */
+static void
+test_zoom_twice_placeholder(void)
+{
+    ViewHelperTest test;
+    cairo_surface_t *surface;
+    cairo_t *cr;
+    GdkRectangle draw_rect = {0, 0, 256, 256};
+
+    setup_helper_test(&test);
+    while (gtk_events_pending()) {
+        gtk_main_iteration();
+    }
+    gegl_node_process(test.out);
+
+    view_helper_set_autoscale_policy(test.helper, GEGL_GTK_VIEW_AUTOSCALE_DISABLED);
+
+    surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 256, 256);
+    cr = cairo_create(surface);
+    view_helper_draw(test.helper, cr, &draw_rect);
+    g_assert_cmpfloat(test.helper->drawn_scale, ==, 1.0);
+
+    view_helper_set_scale(test.helper, 2.0);
+    view_helper_set_scale(test.helper, 4.0);
+    view_helper_draw(test.helper, cr, &draw_rect);
+
+    /* Drawn from the tiles at 1.0, nothing rendered at either new scale */
+    g_assert(!tile_cache_lookup(test.helper->tile_cache, 4.0, 0, 0));
+    g_assert(!cairo_region_is_empty(test.helper->pending_region));
+    g_assert_cmpfloat(test.helper->drawn_scale, ==, 1.0);
+
+    g_timeout_add(300, test_utils_quit_gtk_main, NULL);
+    gtk_main();
+
+    g_assert(tile_cache_lookup(test.helper->tile_cache, 4.0, 0, 0));
+    g_assert_cmpfloat(test.helper->drawn_scale, ==, 4.0);
+
+    cairo_destroy(cr);
+    cairo_surface_destroy(surface);
+    teardown_helper_test(&test);
+}
+
+/* Test that tiles drawn from placeholders are not rendered while
+ * suspended, and are once resumed. */
+static void
+test_suspend_pending(void)
+{
+    ViewHelperTest test;
+    cairo_surface_t *surface;
+    cairo_t *cr;
+    GdkRectangle draw_rect = {0, 0, 256, 256};
+
+    setup_helper_test(&test);
+    while (gtk_events_pending()) {
+        gtk_main_iteration();
+    }
+    gegl_node_process(test.out);
+
+    view_helper_set_autoscale_policy(test.helper, GEGL_GTK_VIEW_AUTOSCALE_DISABLED);
+
+    surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 256, 256);
+    cr = cairo_create(surface);
+    view_helper_draw(test.helper, cr, &draw_rect);
+    view_helper_set_scale(test.helper, 2.0);
+    view_helper_draw(test.helper, cr, &draw_rect);
+    cairo_destroy(cr);
+    cairo_surface_destroy(surface);
+    g_assert(!cairo_region_is_empty(test.helper->pending_region));
+
+    view_helper_set_suspended(test.helper, TRUE);
+    g_assert_cmpuint(test.helper->pending_id, ==, 0);
+
+    g_timeout_add(300, test_utils_quit_gtk_main, NULL);
+    gtk_main();
+    g_assert(!tile_cache_lookup(test.helper->tile_cache, 2.0, 0, 0));
+
+    view_helper_set_suspended(test.helper, FALSE);
+    g_timeout_add(300, test_utils_quit_gtk_main, NULL);
+    gtk_main();
+    g_assert(tile_cache_lookup(test.helper->tile_cache, 2.0, 0, 0));
+    g_assert(cairo_region_is_empty(test.helper->pending_region));
+
+    teardown_helper_test(&test);
+}
+
+/* Test that when zoomed in, model pixels are magnified as sharp squares */
+static void
+test_magnified_draw(void)
+{
+    ViewHelperTest test;
+    cairo_surface_t *surface;
+    cairo_t *cr;
+    GdkRectangle draw_rect = {0, 0, 16, 16};
+    GeglRectangle black_pixel = {1, 1, 1, 1};
+    const guchar black[3] = {0, 0, 0};
+    guint32 *pixels;
+    gint stride;
+
+    setup_helper_test(&test);
+    while (gtk_events_pending()) {
+        gtk_main_iteration();
+    }
+    gegl_buffer_set(test.buffer, &black_pixel, 0, babl_format("R'G'B' u8"),
+                    black, GEGL_AUTO_ROWSTRIDE);
+    gegl_node_process(test.out);
+
+    view_helper_set_autoscale_policy(test.helper, GEGL_GTK_VIEW_AUTOSCALE_DISABLED);
+    view_helper_set_scale(test.helper, 4.0);
+    test.helper->block = TRUE;
+
+    surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 16, 16);
+    cr = cairo_create(surface);
+    view_helper_draw(test.helper, cr, &draw_rect);
+    cairo_destroy(cr);
+
+    cairo_surface_flush(surface);
+    pixels = (guint32 *)cairo_image_surface_get_data(surface);
+    stride = cairo_image_surface_get_stride(surface) / 4;
+    g_assert_cmphex(pixels[3 * stride + 3], ==, 0xffffffff);
+    g_assert_cmphex(pixels[4 * stride + 4], ==, 0xff000000);
+    g_assert_cmphex(pixels[7 * stride + 7], ==, 0xff000000);
+    g_assert_cmphex(pixels[8 * stride + 8], ==, 0xffffffff);
+
+    cairo_surface_destroy(surface);
+    teardown_helper_test(&test);
+}
+
+typedef struct {
+    gint dx;
+    gint dy;
+    gboolean full_redraw;
+} ScrollTestState;
+
+static void
+scroll_needed_event(ViewHelper *helper,
+                    gint dx, gint dy,
+                    ScrollTestState *data)
+{
+    data->dx += dx;
+    data->dy += dy;
+}
+
+static void
+scroll_redraw_event(ViewHelper *helper,
+                    GeglRectangle *rect,
+                    ScrollTestState *data)
+{
+    if (rect->width < 0 || rect->height < 0)
+        data->full_redraw = TRUE;
+}
+
+/* Test that translating the view asks for a scroll instead of a full redraw */
+static void
+test_scroll(void)
+{
+    ViewHelperTest test;
+    ScrollTestState state = { 0, 0, FALSE };
+
+    setup_helper_test(&test);
+    while (gtk_events_pending()) {
+        gtk_main_iteration();
+    }
+
+    g_signal_connect(G_OBJECT(test.helper), "scroll-needed",
+                     G_CALLBACK(scroll_needed_event), &state);
+    g_signal_connect(G_OBJECT(test.helper), "redraw-needed",
+                     G_CALLBACK(scroll_redraw_event), &state);
+
+    view_helper_set_x(test.helper, 10.0);
+    view_helper_set_y(test.helper, -5.0);
+    g_assert_cmpint(state.dx, ==, 10);
+    g_assert_cmpint(state.dy, ==, -5);
+
+    /* Subpixel translations do not change what is drawn */
+    view_helper_set_x(test.helper, 10.5);
+    g_assert_cmpint(state.dx, ==, 10);
+
+    g_assert(!state.full_redraw);
+
+    teardown_helper_test(&test);
+}
+
+typedef struct {
+    gint full_redraws;
+    gint changes;
+} TransformTestState;
+
+static void
+transform_redraw_event(ViewHelper *helper,
+                       GeglRectangle *rect,
+                       TransformTestState *data)
+{
+    if (rect->width < 0 || rect->height < 0)
+        data->full_redraws++;
+}
+
+static void
+transform_changed_event(ViewHelper *helper, TransformTestState *data)
+{
+    data->changes++;
+}
+
+/* Test that changing x, y and scale at once redraws and notifies once */
+static void
+test_set_transform(void)
+{
+    ViewHelperTest test;
+    TransformTestState state = { 0, 0 };
+    ScrollTestState scroll = { 0, 0, FALSE };
+
+    setup_helper_test(&test);
+    while (gtk_events_pending()) {
+        gtk_main_iteration();
+    }
+    view_helper_set_autoscale_policy(test.helper, GEGL_GTK_VIEW_AUTOSCALE_DISABLED);
+
+    g_signal_connect(G_OBJECT(test.helper), "redraw-needed",
+                     G_CALLBACK(transform_redraw_event), &state);
+    g_signal_connect(G_OBJECT(test.helper), "transformation-changed",
+                     G_CALLBACK(transform_changed_event), &state);
+    g_signal_connect(G_OBJECT(test.helper), "scroll-needed",
+                     G_CALLBACK(scroll_needed_event), &scroll);
+
+    view_helper_set_transform(test.helper, 10.0, 20.0, 2.0);
+    g_assert_cmpint(state.full_redraws, ==, 1);
+    g_assert_cmpint(state.changes, ==, 1);
+    g_assert_cmpint(scroll.dx, ==, 0);
+    g_assert_cmpint(scroll.dy, ==, 0);
+
+    g_assert_cmpfloat(view_helper_get_x(test.helper), ==, 10.0);
+    g_assert_cmpfloat(view_helper_get_y(test.helper), ==, 20.0);
+    g_assert_cmpfloat(view_helper_get_scale(test.helper), ==, 2.0);
+
+    /* Setting the same transformation again is a no-op */
+    view_helper_set_transform(test.helper, 10.0, 20.0, 2.0);
+    g_assert_cmpint(state.changes, ==, 1);
+
+    /* Pure translations scroll instead */
+    view_helper_set_transform(test.helper, 15.0, 20.0, 2.0);
+    g_assert_cmpint(state.full_redraws, ==, 1);
+    g_assert_cmpint(state.changes, ==, 2);
+    g_assert_cmpint(scroll.dx, ==, 5);
+
+    teardown_helper_test(&test);
+}
+
+/* Test that scales outside of the supported range are clamped, so that
+ * the coordinate math stays finite and within integer range. */
+static void
+test_scale_range(void)
+{
+    ViewHelperTest test;
+    cairo_surface_t *surface;
+    cairo_t *cr;
+    GdkRectangle draw_rect = {0, 0, 256, 256};
+    GeglRectangle invalidated_rect = {0, 0, 10, 10};
+
+    setup_helper_test(&test);
+    while (gtk_events_pending()) {
+        gtk_main_iteration();
+    }
+    view_helper_set_autoscale_policy(test.helper, GEGL_GTK_VIEW_AUTOSCALE_DISABLED);
+
+    surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 256, 256);
+    cr = cairo_create(surface);
+
+    view_helper_set_scale(test.helper, 0.0);
+    g_assert_cmpfloat(view_helper_get_scale(test.helper), ==, (float)VIEW_HELPER_MIN_SCALE);
+    gegl_node_invalidated(test.out, &invalidated_rect, FALSE);
+    view_helper_draw(test.helper, cr, &draw_rect);
+
+    view_helper_set_scale(test.helper, G_MAXFLOAT);
+    g_assert_cmpfloat(view_helper_get_scale(test.helper), ==, (float)VIEW_HELPER_MAX_SCALE);
+    gegl_node_invalidated(test.out, &invalidated_rect, FALSE);
+    view_helper_draw(test.helper, cr, &draw_rect);
+
+    view_helper_set_x(test.helper, G_MAXINT / 4);
+    gegl_node_invalidated(test.out, &invalidated_rect, FALSE);
+    view_helper_draw(test.helper, cr, &draw_rect);
+
+    g_assert_cmpint(cairo_status(cr), ==, CAIRO_STATUS_SUCCESS);
+    cairo_destroy(cr);
+    cairo_surface_destroy(surface);
+    teardown_helper_test(&test);
+}
+
+/* Test that rapid transform changes make the view interactive, that tiles
+ * are then rendered at reduced quality, and that those are dropped
+ * once the interaction has ended. */
+static void
+test_interactive(void)
+{
+    ViewHelperTest test;
+    cairo_surface_t *surface;
+    cairo_t *cr;
+    GdkRectangle draw_rect = {0, 0, 256, 256};
+
+    setup_helper_test(&test);
+    while (gtk_events_pending()) {
+        gtk_main_iteration();
+    }
+    gegl_node_process(test.out);
+
+    view_helper_set_autoscale_policy(test.helper, GEGL_GTK_VIEW_AUTOSCALE_DISABLED);
+
+    /* Changes within one main loop iteration count as one */
+    view_helper_set_x(test.helper, 10.0);
+    view_helper_set_y(test.helper, 10.0);
+    while (gtk_events_pending()) {
+        gtk_main_iteration();
+    }
+    g_assert(!view_helper_get_interactive(test.helper));
+
+    view_helper_set_x(test.helper, 20.0);
+    while (gtk_events_pending()) {
+        gtk_main_iteration();
+    }
+    g_assert(view_helper_get_interactive(test.helper));
+
+    surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 256, 256);
+    cr = cairo_create(surface);
+    view_helper_draw(test.helper, cr, &draw_rect);
+    cairo_destroy(cr);
+    cairo_surface_destroy(surface);
+
+    g_assert_cmpuint(test.helper->interactive_tiles->len, >, 0);
+    g_assert(tile_cache_lookup(test.helper->tile_cache, 1.0, 0, 0));
+
+    g_timeout_add(500, test_utils_quit_gtk_main, NULL);
+    gtk_main();
+
+    g_assert(!view_helper_get_interactive(test.helper));
+    g_assert_cmpuint(test.helper->interactive_tiles->len, ==, 0);
+    g_assert(!tile_cache_lookup(test.helper->tile_cache, 1.0, 0, 0));
+
+    teardown_helper_test(&test);
+}
+
+/* Test that explicitly set interaction outlasts the quiet period
+ * after rapid transform changes, and lasts until unset. */
+static void
+test_interactive_explicit(void)
+{
+    ViewHelperTest test;
+
+    setup_helper_test(&test);
+    while (gtk_events_pending()) {
+        gtk_main_iteration();
+    }
+
+    view_helper_set_autoscale_policy(test.helper, GEGL_GTK_VIEW_AUTOSCALE_DISABLED);
+
+    view_helper_set_interactive(test.helper, TRUE);
+    view_helper_set_x(test.helper, 10.0);
+    while (gtk_events_pending()) {
+        gtk_main_iteration();
+    }
+    view_helper_set_x(test.helper, 20.0);
+    while (gtk_events_pending()) {
+        gtk_main_iteration();
+    }
+    g_assert(test.helper->interactive_auto);
+
+    g_timeout_add(500, test_utils_quit_gtk_main, NULL);
+    gtk_main();
+    g_assert(view_helper_get_interactive(test.helper));
+
+    view_helper_set_interactive(test.helper, FALSE);
+    g_assert(!view_helper_get_interactive(test.helper));
+
+    teardown_helper_test(&test);
+}
+
+/* Test that the bounding box is only fetched again when an invalidation
+ * may have moved its edges, and that autoscaling ignores tiny changes. */
+static void
+test_cached_bounding_box(void)
+{
+    ViewHelperTest test;
+    GdkRectangle allocation = {0, 0, 514, 514};
+    GeglRectangle inside = {10, 10, 100, 100};
+    GeglRectangle edge = {0, 0, 100, 100};
+
+    setup_helper_test(&test);
+    while (gtk_events_pending()) {
+        gtk_main_iteration();
+    }
+
+    g_assert(test.helper->bbox_valid);
+
+    gegl_node_invalidated(test.out, &inside, FALSE);
+    g_assert(test.helper->bbox_valid);
+
+    gegl_node_invalidated(test.out, &edge, FALSE);
+    g_assert(!test.helper->bbox_valid);
+
+    /* The 512x512 content fits within 1%, the scale is left alone */
+    view_helper_set_allocation(test.helper, &allocation);
+    g_assert(test.helper->bbox_valid);
+    g_assert_cmpfloat(view_helper_get_scale(test.helper), ==, 1.0);
+
+    teardown_helper_test(&test);
+}
+
+/* Test that only the visible part of an invalidation is processed,
+ * and that the rest is processed once it is scrolled into view. */
+static void
+test_visible_processing(void)
+{
+    ViewHelperTest test;
+    GdkRectangle allocation = {0, 0, 100, 100};
+    GeglRectangle invalidated_rect = {0, 0, 512, 512};
+    GeglRectangle expected_rect = {0, 0, 102, 102};
+    GeglRectangle queued_rect;
+    cairo_rectangle_int_t visible_area = {300, 0, 102, 102};
+    cairo_rectangle_int_t extents;
+
+    setup_helper_test(&test);
+    while (gtk_events_pending()) {
+        gtk_main_iteration();
+    }
+
+    view_helper_set_autoscale_policy(test.helper, GEGL_GTK_VIEW_AUTOSCALE_DISABLED);
+    view_helper_set_allocation(test.helper, &allocation);
+
+    gegl_node_invalidated(test.out, &invalidated_rect, FALSE);
+    g_assert_cmpint(cairo_region_num_rectangles(test.helper->processing_region), ==, 1);
+    cairo_region_get_extents(test.helper->processing_region, &extents);
+    gegl_rectangle_set(&queued_rect, extents.x, extents.y, extents.width, extents.height);
+    g_assert(test_utils_compare_rect(&queued_rect, &expected_rect));
+    g_assert(!cairo_region_is_empty(test.helper->deferred_region));
+
+    view_helper_set_x(test.helper, 300.0);
+    g_assert(cairo_region_contains_rectangle(test.helper->processing_region, &visible_area)
+             == CAIRO_REGION_OVERLAP_IN);
+    g_assert(cairo_region_contains_rectangle(test.helper->deferred_region, &visible_area)
+             == CAIRO_REGION_OVERLAP_OUT);
+
+    teardown_helper_test(&test);
+}
+
+/* Test that nothing is processed while suspended, and that only
+ * the visible part is processed when resumed. */
+static void
+test_suspended_processing(void)
+{
+    ViewHelperTest test;
+    GdkRectangle allocation = {0, 0, 100, 100};
+    cairo_rectangle_int_t node_area = {0, 0, 512, 512};
+    cairo_rectangle_int_t extents;
+
+    test.helper = view_helper_new();
+    view_helper_set_autoscale_policy(test.helper, GEGL_GTK_VIEW_AUTOSCALE_DISABLED);
+    view_helper_set_suspended(test.helper, TRUE);
+
+    setup_helper_test_node(&test);
+
+    g_assert(cairo_region_is_empty(test.helper->processing_region));
+    g_assert(cairo_region_contains_rectangle(test.helper->deferred_region, &node_area)
+             == CAIRO_REGION_OVERLAP_IN);
+
+    view_helper_set_allocation(test.helper, &allocation);
+    g_assert(cairo_region_is_empty(test.helper->processing_region));
+
+    view_helper_set_suspended(test.helper, FALSE);
+    cairo_region_get_extents(test.helper->processing_region, &extents);
+    g_assert_cmpint(extents.width, ==, 102);
+    g_assert_cmpint(extents.height, ==, 102);
+    g_assert(!cairo_region_is_empty(test.helper->deferred_region));
+
+    teardown_helper_test(&test);
+}
+
+/* Test that suspending defers the queued work and holds back redraws,
+ * and that resuming picks the work up again with a single full redraw. */
+static void
+test_suspend_queued(void)
+{
+    ViewHelperTest test;
+    TransformTestState state = { 0, 0 };
+    GdkRectangle allocation = {0, 0, 100, 100};
+    GeglRectangle invalidated_rect = {0, 0, 50, 50};
+    cairo_rectangle_int_t invalidated_area = {0, 0, 50, 50};
+
+    setup_helper_test(&test);
+    while (gtk_events_pending()) {
+        gtk_main_iteration();
+    }
+    view_helper_set_autoscale_policy(test.helper, GEGL_GTK_VIEW_AUTOSCALE_DISABLED);
+    view_helper_set_allocation(test.helper, &allocation);
+
+    g_signal_connect(G_OBJECT(test.helper), "redraw-needed",
+                     G_CALLBACK(transform_redraw_event), &state);
+
+    gegl_node_invalidated(test.out, &invalidated_rect, FALSE);
+    g_assert(!cairo_region_is_empty(test.helper->processing_region));
+
+    view_helper_set_suspended(test.helper, TRUE);
+    g_assert(cairo_region_is_empty(test.helper->processing_region));
+    g_assert(cairo_region_contains_rectangle(test.helper->deferred_region, &invalidated_area)
+             == CAIRO_REGION_OVERLAP_IN);
+
+    view_helper_set_scale(test.helper, 2.0);
+    view_helper_set_x(test.helper, 10.0);
+    g_assert_cmpint(state.full_redraws, ==, 0);
+
+    view_helper_set_suspended(test.helper, FALSE);
+    g_assert(!cairo_region_is_empty(test.helper->processing_region));
+    g_assert_cmpint(state.full_redraws, ==, 1);
+
+    teardown_helper_test(&test);
+}
+
+/* Test that overlapping invalidations are merged, so that no pixel
+ * is scheduled for processing more than once. */
+static void
+test_merged_invalidations(void)
+{
+    ViewHelperTest test;
+    GeglRectangle first = {0, 0, 100, 100};
+    GeglRectangle second = {50, 50, 100, 100};
+    cairo_rectangle_int_t r;
+    gint i, area = 0;
+
+    setup_helper_test(&test);
+    while (gtk_events_pending()) {
+        gtk_main_iteration();
+    }
+
+    gegl_node_invalidated(test.out, &first, FALSE);
+    gegl_node_invalidated(test.out, &second, FALSE);
+    gegl_node_invalidated(test.out, &first, FALSE);
+
+    for (i = 0; i < cairo_region_num_rectangles(test.helper->processing_region); i++) {
+        cairo_region_get_rectangle(test.helper->processing_region, i, &r);
+        area += r.width * r.height;
+    }
+    g_assert_cmpint(area, ==, 2 * 100 * 100 - 50 * 50);
+
+    teardown_helper_test(&test);
+}
+
+static void
+threaded_redraw_event(ViewHelper *helper,
+                      GeglRectangle *rect,
+                      gboolean *got_redraw)
+{
+    /* Redraws must be requested from the main thread */
+    g_assert(g_thread_self() == helper->main_thread);
+    *got_redraw = TRUE;
+}
+
+/* Test that the node is processed in threaded mode,
+ * and that the results are passed on to the main thread. */
+static void
+test_threaded_processing(void)
+{
+    ViewHelperTest test;
+    gboolean got_redraw = FALSE;
+    GeglRectangle invalidated_rect = {0, 0, 128, 128};
+
+    setup_helper_test(&test);
+    view_helper_set_threaded(test.helper, TRUE);
+    g_assert(view_helper_get_threaded(test.helper));
+
+    g_signal_connect(G_OBJECT(test.helper), "redraw-needed",
+                     G_CALLBACK(threaded_redraw_event), &got_redraw);
+
+    gegl_node_invalidated(test.out, &invalidated_rect, FALSE);
+
+    g_timeout_add(300, test_utils_quit_gtk_main, NULL);
+    gtk_main();
+
+    g_assert(got_redraw);
+
+    view_helper_set_threaded(test.helper, FALSE);
+    teardown_helper_test(&test);
+}
+
+/* Test that the graph can be modified while locked in threaded mode,
+ * including the signals this emits being handled by the helper */
+static void
+test_graph_lock(void)
+{
+    ViewHelperTest test;
+    gboolean got_redraw = FALSE;
+    GeglRectangle invalidated_rect = {0, 0, 600, 600};
+    GdkRectangle allocation = {0, 0, 512, 512};
+
+    setup_helper_test(&test);
+    view_helper_set_threaded(test.helper, TRUE);
+
+    g_signal_connect(G_OBJECT(test.helper), "redraw-needed",
+                     G_CALLBACK(threaded_redraw_event), &got_redraw);
+
+    view_helper_lock_graph(test.helper);
+    view_helper_lock_graph(test.helper);
+    gegl_node_link_many(test.loadbuf, test.out, NULL);
+    /* Beyond the bounding box, so that it is fetched again, with the lock held */
+    gegl_node_invalidated(test.out, &invalidated_rect, FALSE);
+    g_assert(!test.helper->bbox_valid);
+    view_helper_set_allocation(test.helper, &allocation);
+    g_assert(test.helper->bbox_valid);
+    view_helper_unlock_graph(test.helper);
+    view_helper_unlock_graph(test.helper);
+
+    g_timeout_add(300, test_utils_quit_gtk_main, NULL);
+    gtk_main();
+
+    g_assert(got_redraw);
+
+    view_helper_set_threaded(test.helper, FALSE);
+    teardown_helper_test(&test);
+}
+
+typedef struct {
+    ViewHelper *helper;
+    GMutex      mutex;
+    GCond       cond;
+    gboolean    locked;
+    gboolean    release;
+} LockHolder;
+
+/* Holds the process lock like the worker thread does while processing */
+static gpointer
+hold_process_lock(gpointer data)
+{
+    LockHolder *holder = data;
+
+    g_rec_mutex_lock(&holder->helper->process_mutex);
+    g_mutex_lock(&holder->mutex);
+    holder->locked = TRUE;
+    g_cond_signal(&holder->cond);
+    while (!holder->release)
+        g_cond_wait(&holder->cond, &holder->mutex);
+    g_mutex_unlock(&holder->mutex);
+    g_rec_mutex_unlock(&holder->helper->process_mutex);
+
+    return NULL;
+}
+
+/* Test that drawing while the worker holds the node still paints
+ * what has been computed, instead of leaving holes */
+static void
+test_draw_while_processing(void)
+{
+    ViewHelperTest test;
+    LockHolder holder;
+    GThread *thread;
+    cairo_surface_t *surface;
+    cairo_t *cr;
+    GdkRectangle draw_rect = {0, 0, 256, 256};
+    guint32 *pixel;
+
+    setup_helper_test(&test);
+    while (gtk_events_pending()) {
+        gtk_main_iteration();
+    }
+    gegl_node_process(test.out);
+
+    holder.helper = test.helper;
+    g_mutex_init(&holder.mutex);
+    g_cond_init(&holder.cond);
+    holder.locked = FALSE;
+    holder.release = FALSE;
+    thread = g_thread_new("hold-process-lock", hold_process_lock, &holder);
+
+    g_mutex_lock(&holder.mutex);
+    while (!holder.locked)
+        g_cond_wait(&holder.cond, &holder.mutex);
+    g_mutex_unlock(&holder.mutex);
+
+    surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 256, 256);
+    cr = cairo_create(surface);
+    view_helper_draw(test.helper, cr, &draw_rect);
+    cairo_destroy(cr);
+
+    cairo_surface_flush(surface);
+    pixel = (guint32 *)cairo_image_surface_get_data(surface);
+    g_assert_cmphex(pixel[0], ==, 0xffffffff);
+    g_assert(tile_cache_lookup(test.helper->tile_cache, 1.0, 0, 0));
+
+    g_mutex_lock(&holder.mutex);
+    holder.release = TRUE;
+    g_cond_signal(&holder.cond);
+    g_mutex_unlock(&holder.mutex);
+    g_thread_join(thread);
+    g_mutex_clear(&holder.mutex);
+    g_cond_clear(&holder.cond);
+
+    cairo_surface_destroy(surface);
+    teardown_helper_test(&test);
+}
+
+/* Test that the dirty region is processed tile by tile,
+ * starting with the tile under the pointer. */
+static void
+test_processing_order(void)
+{
+    ViewHelperTest test;
+    GdkRectangle allocation = {0, 0, 512, 512};
+    GeglRectangle invalidated_rect = {0, 0, 512, 512};
+    cairo_rectangle_int_t pointer_tile = {256, 256, 256, 256};
+    cairo_rectangle_int_t far_tile = {0, 0, 256, 256};
+
+    setup_helper_test(&test);
+    while (gtk_events_pending()) {
+        gtk_main_iteration();
+    }
+
+    view_helper_set_autoscale_policy(test.helper, GEGL_GTK_VIEW_AUTOSCALE_DISABLED);
+    view_helper_set_allocation(test.helper, &allocation);
+    view_helper_set_processing_budget(test.helper, 0);
+    view_helper_set_pointer(test.helper, TRUE, 400.0, 400.0);
+
+    gegl_node_invalidated(test.out, &invalidated_rect, FALSE);
+    g_main_context_iteration(NULL, FALSE);
+
+    g_assert(cairo_region_contains_rectangle(test.helper->processing_region, &pointer_tile)
+             == CAIRO_REGION_OVERLAP_OUT);
+    g_assert(cairo_region_contains_rectangle(test.helper->processing_region, &far_tile)
+             == CAIRO_REGION_OVERLAP_IN);
+
+    teardown_helper_test(&test);
+}
+
+/* Test that in progressive mode, a coarse pass over the invalidated area
+ * is done before it is processed at full resolution. */
+static void
+test_progressive_processing(void)
+{
+    ViewHelperTest test;
+    GeglRectangle invalidated_rect = {0, 0, 512, 512};
+    cairo_rectangle_int_t area = {0, 0, 512, 512};
+    gint i;
+
+    setup_helper_test(&test);
+    while (gtk_events_pending()) {
+        gtk_main_iteration();
+    }
+
+    view_helper_set_autoscale_policy(test.helper, GEGL_GTK_VIEW_AUTOSCALE_DISABLED);
+    view_helper_set_processing_budget(test.helper, 0);
+    view_helper_set_progressive(test.helper, TRUE);
+
+    gegl_node_invalidated(test.out, &invalidated_rect, FALSE);
+    g_assert(cairo_region_contains_rectangle(test.helper->coarse_queue, &area)
+             == CAIRO_REGION_OVERLAP_IN);
+
+    for (i = 0; i < 100 && cairo_region_is_empty(test.helper->coarse_region); i++) {
+        g_main_context_iteration(NULL, FALSE);
+    }
+    g_assert(cairo_region_contains_rectangle(test.helper->coarse_region, &area)
+             == CAIRO_REGION_OVERLAP_IN);
+    g_assert(cairo_region_is_empty(test.helper->coarse_queue));
+    g_assert(!cairo_region_is_empty(test.helper->processing_region));
+
+    /* Refined to full resolution afterwards */
+    g_timeout_add(300, test_utils_quit_gtk_main, NULL);
+    gtk_main();
+
+    g_assert(cairo_region_is_empty(test.helper->processing_region));
+    g_assert(cairo_region_is_empty(test.helper->coarse_region));
+
+    teardown_helper_test(&test);
+}
+
+/* Test that when zoomed out, the node is processed at the matching level
+ * of detail, and that zooming in queues the area at full resolution. */
+static void
+test_lod_processing(void)
+{
+    ViewHelperTest test;
+    GeglRectangle invalidated_rect = {0, 0, 512, 512};
+    cairo_rectangle_int_t area = {0, 0, 512, 512};
+
+    setup_helper_test(&test);
+    while (gtk_events_pending()) {
+        gtk_main_iteration();
+    }
+
+    view_helper_set_autoscale_policy(test.helper, GEGL_GTK_VIEW_AUTOSCALE_DISABLED);
+    view_helper_set_scale(test.helper, 0.25);
+    g_assert_cmpint(test.helper->view_level, ==, 2);
+
+    gegl_node_invalidated(test.out, &invalidated_rect, FALSE);
+
+    g_timeout_add(300, test_utils_quit_gtk_main, NULL);
+    gtk_main();
+
+    g_assert(cairo_region_is_empty(test.helper->processing_region));
+    g_assert(cairo_region_contains_rectangle(test.helper->lod_region[2], &area)
+             == CAIRO_REGION_OVERLAP_IN);
+
+    view_helper_set_scale(test.helper, 1.0);
+    g_assert(cairo_region_is_empty(test.helper->lod_region[2]));
+    g_assert(cairo_region_contains_rectangle(test.helper->processing_region, &area)
+             == CAIRO_REGION_OVERLAP_IN);
+
+    teardown_helper_test(&test);
+}
+
+static void
+count_computed_pixels(GeglNode      *node,
+                      GeglRectangle *rect,
+                      gint          *pixels)
+{
+    *pixels += rect->width * rect->height;
+}
+
+/* Test that work queued for a node is dropped when the node is swapped out,
+ * by counting how many pixels get processed after a rapid node swap. */
+static void
+test_cancel_on_node_change(void)
+{
+    ViewHelperTest test;
+    GeglNode *graph, *other;
+    gint old_pixels = 0, new_pixels = 0;
+    GeglRectangle other_rect = {0, 0, 64, 64};
+    GeglRectangle bbox;
+
+    setup_helper_test(&test);
+    while (gtk_events_pending()) {
+        gtk_main_iteration();
+    }
+
+    graph = gegl_node_new();
+    other = gegl_node_new_child(graph,
+                                "operation", "gegl:rectangle",
+                                "x", 0.0, "y", 0.0,
+                                "width", 64.0, "height", 64.0,
+                                NULL);
+
+    g_signal_connect(test.out, "computed",
+                     G_CALLBACK(count_computed_pixels), &old_pixels);
+    g_signal_connect(other, "computed",
+                     G_CALLBACK(count_computed_pixels), &new_pixels);
+
+    /* Queue work for the original node, then swap before it is processed */
+    bbox = gegl_node_get_bounding_box(test.out);
+    gegl_node_invalidated(test.out, &bbox, FALSE);
+    view_helper_set_node(test.helper, other);
+
+    g_timeout_add(300, test_utils_quit_gtk_main, NULL);
+    gtk_main();
+
+    g_assert_cmpint(old_pixels, ==, 0);
+    g_assert_cmpint(new_pixels, >, 0);
+    g_assert_cmpint(new_pixels, <=, other_rect.width * other_rect.height);
+
+    g_object_unref(graph);
+    teardown_helper_test(&test);
+}
+
+/* Draw until warmed up, then check that drawing again after invalidations
+ * does not allocate */
+static void
+assert_no_allocation_after_warmup(ViewHelperTest *test, cairo_t *cr)
+{
+    GdkRectangle draw_rect = {0, 0, 256, 256};
+    GeglRectangle invalidated_rect = {0, 0, 10, 10};
+    guint allocations;
+    gint i;
+
+    /* Warm up, including the tiles drawn from placeholders after a zoom */
+    view_helper_draw(test->helper, cr, &draw_rect);
+    while (gtk_events_pending()) {
+        gtk_main_iteration();
+    }
+    view_helper_draw(test->helper, cr, &draw_rect);
+    allocations = surface_pool_get_allocations(test->helper->surface_pool);
+    g_assert_cmpuint(allocations, >, 0);
+
+    for (i = 0; i < 10; i++) {
+        gegl_node_invalidated(test->out, &invalidated_rect, FALSE);
+        view_helper_draw(test->helper, cr, &draw_rect);
+    }
+    g_assert_cmpuint(surface_pool_get_allocations(test->helper->surface_pool), ==, allocations);
+}
+
+/* Test that once warmed up, drawing does not allocate staging surfaces,
+ * also when tiles have to be rendered again after an invalidation.
+ * Covers magnified tiles, and the reduced tiles drawn while interactive. */
+static void
+test_no_allocation_after_warmup(void)
+{
+    ViewHelperTest test;
+    cairo_surface_t *surface;
+    cairo_t *cr;
+
+    setup_helper_test(&test);
+    while (gtk_events_pending()) {
+        gtk_main_iteration();
+    }
+    gegl_node_process(test.out);
+
+    surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 256, 256);
+    cr = cairo_create(surface);
+
+    assert_no_allocation_after_warmup(&test, cr);
+
+    view_helper_set_scale(test.helper, 2.0);
+    view_helper_set_interactive(test.helper, FALSE);
+    assert_no_allocation_after_warmup(&test, cr);
+
+    view_helper_set_interactive(test.helper, TRUE);
+    assert_no_allocation_after_warmup(&test, cr);
+
+    view_helper_set_scale(test.helper, 0.5);
+    assert_no_allocation_after_warmup(&test, cr);
+    view_helper_set_interactive(test.helper, FALSE);
+
+    cairo_destroy(cr);
+    cairo_surface_destroy(surface);
+    teardown_helper_test(&test);
+}
+
 int
 main(int argc, char **argv)
 {
@@ -206,6 +1374,33 @@ main(int argc, char **argv)
     g_test_add_func("/widgets/view/redraw-scaled", test_redraw_scaled);
     g_test_add_func("/widgets/view/redraw-translated", test_redraw_translated);
     g_test_add_func("/widgets/view/redraw-combined", test_redraw_combined);
+    g_test_add_func("/widgets/view/helper/tile-cache", test_tile_cache);
+    g_test_add_func("/widgets/view/helper/tile-cache-eviction", test_tile_cache_eviction);
+    g_test_add_func("/widgets/view/helper/stats", test_stats);
+    g_test_add_func("/widgets/view/helper/parallel-draw", test_parallel_draw);
+    g_test_add_func("/widgets/view/helper/draw-region", test_draw_region);
+    g_test_add_func("/widgets/view/helper/zoom-placeholder", test_zoom_placeholder);
+    g_test_add_func("/widgets/view/helper/zoom-twice-placeholder", test_zoom_twice_placeholder);
+    g_test_add_func("/widgets/view/helper/suspend-pending", test_suspend_pending);
+    g_test_add_func("/widgets/view/helper/magnified-draw", test_magnified_draw);
+    g_test_add_func("/widgets/view/helper/scroll", test_scroll);
+    g_test_add_func("/widgets/view/helper/set-transform", test_set_transform);
+    g_test_add_func("/widgets/view/helper/scale-range", test_scale_range);
+    g_test_add_func("/widgets/view/helper/interactive", test_interactive);
+    g_test_add_func("/widgets/view/helper/interactive-explicit", test_interactive_explicit);
+    g_test_add_func("/widgets/view/helper/cached-bounding-box", test_cached_bounding_box);
+    g_test_add_func("/widgets/view/helper/visible-processing", test_visible_processing);
+    g_test_add_func("/widgets/view/helper/suspended-processing", test_suspended_processing);
+    g_test_add_func("/widgets/view/helper/suspend-queued", test_suspend_queued);
+    g_test_add_func("/widgets/view/helper/merged-invalidations", test_merged_invalidations);
+    g_test_add_func("/widgets/view/helper/threaded-processing", test_threaded_processing);
+    g_test_add_func("/widgets/view/helper/graph-lock", test_graph_lock);
+    g_test_add_func("/widgets/view/helper/draw-while-processing", test_draw_while_processing);
+    g_test_add_func("/widgets/view/helper/processing-order", test_processing_order);
+    g_test_add_func("/widgets/view/helper/progressive-processing", test_progressive_processing);
+    g_test_add_func("/widgets/view/helper/lod-processing", test_lod_processing);
+    g_test_add_func("/widgets/view/helper/cancel-on-node-change", test_cancel_on_node_change);
+    g_test_add_func("/widgets/view/helper/no-allocation-after-warmup", test_no_allocation_after_warmup);
 
     retval = g_test_run();
     gegl_exit();